@@ -24,6 +24,11 @@
 #include	"msc-handler.h"
 #include	"radio.h"
 #include	"dab-params.h"
+#include	"sample-kernels.h"
+#include	"demod-kernels.h"
+#ifdef	__SYNC_STATISTICS
+#include	<chrono>
+#endif
 //
 /**
   *	\brief dabProcessor
@@ -34,11 +39,18 @@
   */
 
 #define	C_LEVEL_SIZE	50
+#define	SYNC_BUFFERSIZE	32768
+#define	SYNC_BUFFERMASK	(SYNC_BUFFERSIZE - 1)
+#define	SCAN_BLOCKSIZE	512
 	dabProcessor::dabProcessor	(RadioInterface	*mr,
 	                                 virtualInput	*theDevice,
 	                                 uint8_t	dabMode,
 	                                 int16_t	threshold,
 	                                 int16_t	diff_length,
+	                                 int16_t	trackWindow,
+	                                 int16_t	trackMisses,
+	                                 bool		acquisition,
+	                                 int16_t	ficDutyCycle,
 	                                 QString	picturesPath):
 	                                 params (dabMode),
 	                                 myReader (mr, theDevice),
@@ -66,8 +78,29 @@ int32_t	i;
 	this	-> carriers		= params. get_carriers ();
 	this	-> carrierDiff		= params. get_carrierDiff ();
 	this	-> giveSignal		= false;
+	this	-> probing		= false;
+	this	-> trackWindow		= trackWindow;
+	this	-> trackMisses		= trackMisses;
+	this	-> T_g			= T_s - T_u;
+	tracking			= false;
+	missCount			= 0;
+	expectedIndex			= T_g;
+	this	-> acquisition		= acquisition;
+	my_ficHandler. setDutyCycle (ficDutyCycle);
+	acquired			= false;
+	carrierOffset			= 0;
+#ifdef	__SYNC_STATISTICS
+	syncTime			= 0;
+	syncFrames			= 0;
+	fullSearches			= 0;
+	syncMisses			= 0;
+	acquisitionFrames		= 0;
+#endif
 
 	ofdmBuffer. resize (2 * T_s);
+	envBuffer. resize (SYNC_BUFFERSIZE);
+	syncBufferIndex			= 0;
+	cLevel				= 0;
 	ofdmBufferIndex			= 0;
 	ofdmSymbolCount			= 0;
 	tokenCount			= 0;
@@ -75,6 +108,8 @@ int32_t	i;
 	f2Correction			= true;
 	attempts			= 0;
 	myReader. setRunning  (false);
+	connect (&my_ficHandler, SIGNAL (ensembleComplete (void)),
+	         this, SIGNAL (ensembleComplete (void)));
 }
 
 	dabProcessor::~dabProcessor	(void) {
@@ -93,9 +128,184 @@ void	dabProcessor::start (int frequency, bool giveSignal) {
 	theDevice	-> restartReader ();
 	theDevice	-> setVFOFrequency (frequency);
 	this		-> giveSignal = giveSignal;
+	this		-> probing	= false;
+	this -> QThread::start ();
+}
+//
+//	startProbe is used while scanning: only the FIC (blocks 0 .. 3)
+//	is demodulated and decoded, the MSC blocks are merely read to
+//	keep time and frequency. ensembleComplete is signalled as soon
+//	as the ensemble description is complete, No_Signal_Found when
+//	there is no DAB signal at all
+void	dabProcessor::startProbe (int frequency) {
+	theDevice	-> restartReader ();
+	theDevice	-> setVFOFrequency (frequency);
+	this		-> giveSignal	= true;
+	this		-> probing	= true;
 	this -> QThread::start ();
 }
 	
+//
+//	scanEnvelope looks - in blocks of samples rather than sample
+//	by sample - for the moment the average envelope over the last
+//	C_LEVEL_SIZE samples drops below (onNull) or rises above
+//	(!onNull) factor * sLevel. The samples beyond that moment remain
+//	in the reader. The function returns false if that moment is not
+//	found within "limit" samples.
+static inline
+bool	searching (bool onNull, float cLevel, float sLevel, double factor) {
+	return onNull ? cLevel / C_LEVEL_SIZE > factor * sLevel :
+	                cLevel / C_LEVEL_SIZE < factor * sLevel;
+}
+
+bool	dabProcessor::scanEnvelope (bool onNull,
+	                            double factor, int32_t limit) {
+int32_t	counter	= 0;
+float	sLevel	= myReader. get_sLevel ();
+const float *env;
+int32_t	amount;
+int32_t	i;
+
+	while (searching (onNull, cLevel, sLevel, factor)) {
+	   amount = myReader. peekEnvelope (&env, SCAN_BLOCKSIZE,
+	                                    coarseOffset + fineCorrector);
+	   for (i = 0; i < amount; i ++) {
+	      sLevel	= nextLevel (sLevel, env [i]);
+	      envBuffer [syncBufferIndex] = env [i];
+//	update the levels
+	      cLevel += envBuffer [syncBufferIndex] -
+	                envBuffer [(syncBufferIndex - C_LEVEL_SIZE) &
+	                                              SYNC_BUFFERMASK];
+	      syncBufferIndex = (syncBufferIndex + 1) & SYNC_BUFFERMASK;
+	      counter ++;
+	      if (counter > limit) {
+	         myReader. consume (i + 1);
+	         return false;
+	      }
+	      if (!searching (onNull, cLevel, sLevel, factor)) {
+	         myReader. consume (i + 1);
+	         return true;
+	      }
+	   }
+	   myReader. consume (amount);
+	}
+	return true;
+}
+
+//
+//	Locating the first sample of block 0 in the T_u samples
+//	in ofdmBuffer.
+//	When tracking, the correlation is only computed near the
+//	index found in the previous frame. A miss there is bridged
+//	by taking the expected index, only after trackMisses misses
+//	in a row the full search (FFT, IFFT) is done again.
+//	As long as the frequency offset is not known, the full search
+//	is the joint time and frequency acquisition.
+int32_t	dabProcessor::syncIndex	(void) {
+int32_t	index;
+#ifdef	__SYNC_STATISTICS
+auto	t0	= std::chrono::steady_clock::now ();
+#endif
+	acquired	= false;
+	if (!tracking) {
+	   if (acquisition && f2Correction) {
+	      index = phaseSynchronizer. acquire (ofdmBuffer. data (),
+	                                          &carrierOffset);
+	      acquired	= index >= 0;
+	   }
+	   else
+	      index = phaseSynchronizer. findIndex (ofdmBuffer. data ());
+	}
+	else {
+	   index = phaseSynchronizer. trackIndex (ofdmBuffer. data (),
+	                                          expectedIndex, trackWindow);
+	   if (index >= 0)
+	      missCount	= 0;
+	   else
+	   if (++missCount <= trackMisses) {
+	      index	= expectedIndex;
+#ifdef	__SYNC_STATISTICS
+	      syncMisses ++;
+#endif
+	   }
+	   else {
+	      missCount	= 0;
+	      index	= phaseSynchronizer. findIndex (ofdmBuffer. data ());
+#ifdef	__SYNC_STATISTICS
+	      fullSearches ++;
+#endif
+	   }
+	   if (index >= 0)
+	      expectedIndex	= index;
+	}
+#ifdef	__SYNC_STATISTICS
+	if (!tracking)
+	   fullSearches ++;
+	syncTime	+= std::chrono::duration <double, std::micro>
+	                  (std::chrono::steady_clock::now () - t0). count ();
+	if (++syncFrames >= 100) {
+	   fprintf (stderr,
+	            "sync: %.1f usec per frame, %d full searches, %d misses in %d frames\n",
+	            syncTime / syncFrames, fullSearches, syncMisses, syncFrames);
+	   syncTime	= 0;
+	   syncFrames	= 0;
+	   fullSearches	= 0;
+	   syncMisses	= 0;
+	}
+#endif
+	return index;
+}
+
+//
+//	After an acquisition, the "prefix" samples preceding block 0
+//	in ofdmBuffer are (the last part of) its cyclic prefix, and
+//	correlating them with the end of block 0 gives the fractional
+//	part of the frequency offset, as it is done for the other
+//	blocks. The integer part is the one that brings it closest
+//	to the (rough) offset from the acquisition, the offset
+//	is then set in one step.
+//	With less than a quarter of the cyclic prefix, the phase of the
+//	correlation is too noisy to go by, then only the integer part
+//	is taken and the fine tracking per frame does the rest.
+//	The samples of block 0 were read with the old offset, they are
+//	corrected as if the oscillator had been on the new one all the
+//	time. The last sample read needs no correction, the phase of
+//	the oscillator continues from there.
+void	dabProcessor::seedOffsets (int32_t prefix) {
+int32_t	oldOffset	= coarseOffset + fineCorrector;
+int32_t	delta;
+int32_t	i;
+float	fraction	= 0;
+
+	if (prefix >= T_g / 4) {
+	   std::complex<float> c = lagProduct (&ofdmBuffer [T_u],
+	                                       ofdmBuffer. data (), prefix);
+	   fraction	= fastArg (c) / (2 * M_PI);
+	   fineCorrector	+= fraction * carrierDiff;
+	}
+	coarseOffset	+= lrintf (carrierOffset - fraction) * carrierDiff;
+	if (fineCorrector > carrierDiff / 2) {
+	   coarseOffset += carrierDiff;
+	   fineCorrector -= carrierDiff;
+	}
+	else
+	if (fineCorrector < -carrierDiff / 2) {
+	   coarseOffset -= carrierDiff;
+	   fineCorrector += carrierDiff;
+	}
+	if (abs (coarseOffset) > Khz (35))
+	   coarseOffset = 0;
+
+	delta	= coarseOffset + fineCorrector - oldOffset;
+	std::complex<double> step =
+	                 std::polar (1.0, 2 * M_PI * delta / INPUT_RATE);
+	std::complex<double> w	= 1;
+	for (i = prefix + T_u - 1; i >= 0; i --) {
+	   ofdmBuffer [i] *= std::complex<float> (w);
+	   w	*= step;
+	}
+}
+
 /***
    *	\brief run
    *	The main thread, reading samples,
@@ -106,16 +316,11 @@ void	dabProcessor::start (int frequency, bool giveSignal) {
    */
 void	dabProcessor::run	(void) {
 int32_t		startIndex;
-int32_t		i;
+int32_t		prefix;
+int32_t		i, j;
 std::complex<float>	FreqCorr;
-int32_t		counter;
-float		cLevel;
-int32_t		syncBufferIndex	= 0;
-const
-int32_t		syncBufferSize	= 32768;
-const
-int32_t		syncBufferMask	= syncBufferSize - 1;
-float		envBuffer	[syncBufferSize];
+const float	*env;
+int32_t		amount;
 
         fineCorrector   = 0;
         f2Correction    = true;
@@ -123,25 +328,38 @@ float		envBuffer	[syncBufferSize];
 	attempts	= 0;
         theDevice  -> resetBuffer ();
 	theDevice	-> restartReader ();
+	myReader. resetBuffer ();
 	coarseOffset	= 0;
+#ifdef	__SYNC_STATISTICS
+	acquisitionFrames	= 0;
+#endif
 	myReader. setRunning (true);
 	my_ofdmDecoder. start ();
 //
 //	to get some idea of the signal strength
 	try {
-	   for (i = 0; i < T_F / 5; i ++) {
-	      myReader. getSample (0);
+	   for (i = 0; i < T_F / 5; i += amount) {
+	      amount = myReader. peekEnvelope (&env,
+	                                       T_F / 5 - i < SCAN_BLOCKSIZE ?
+	                                       T_F / 5 - i : SCAN_BLOCKSIZE, 0);
+	      myReader. consume (amount);
 	   }
 Initing:
 notSynced:
+	   my_ficHandler. fullRate ();
+	   tracking		= false;
+	   missCount		= 0;
 	   syncBufferIndex	= 0;
 	   cLevel		= 0;
 
-	   for (i = 0; i < C_LEVEL_SIZE; i ++) {
-	      std::complex<float> sample	= myReader. getSample (0);
-	      envBuffer [syncBufferIndex]	= jan_abs (sample);
-	      cLevel	 			+= envBuffer [syncBufferIndex];
-	      syncBufferIndex ++;
+	   for (i = 0; i < C_LEVEL_SIZE; i += amount) {
+	      amount = myReader. peekEnvelope (&env, C_LEVEL_SIZE - i, 0);
+	      for (j = 0; j < amount; j ++) {
+	         envBuffer [syncBufferIndex]	= env [j];
+	         cLevel				+= envBuffer [syncBufferIndex];
+	         syncBufferIndex ++;
+	      }
+	      myReader. consume (amount);
 	   }
 /**
   *	We now have initial values for cLevel (i.e. the sum
@@ -151,45 +369,21 @@ SyncOnNull:
 /**
   *	here we start looking for the null level, i.e. a dip
   */
-	   counter	= 0;
 	   setSynced (false);
-	   while (cLevel / C_LEVEL_SIZE  > 0.40 * myReader. get_sLevel ()) {
-	      std::complex<float> sample	=
-	                      myReader. getSample (coarseOffset + fineCorrector);
-	      envBuffer [syncBufferIndex] = jan_abs (sample);
-//	update the levels
-	      cLevel += envBuffer [syncBufferIndex] -
-	                envBuffer [(syncBufferIndex - C_LEVEL_SIZE) & syncBufferMask];
-	      syncBufferIndex = (syncBufferIndex + 1) & syncBufferMask;
-	      counter ++;
-	      if (counter > T_F) { // hopeless
-	         if (giveSignal && (++ attempts >= 5)) {
-	            emit (No_Signal_Found ());
-                    attempts = 0;
-                 }
-	         goto notSynced;
-	      }
+	   if (!scanEnvelope (true, 0.40, T_F)) {	// hopeless
+	      if (giveSignal && (++ attempts >= 5)) {
+	         emit (No_Signal_Found ());
+                 attempts = 0;
+              }
+	      goto notSynced;
 	   }
 /**
   *	It seemed we found a dip that started app 65/100 * 50 samples earlier.
   *	We now start looking for the end of the null period.
   */
-	   counter	= 0;
 SyncOnEndNull:
-	   while (cLevel / C_LEVEL_SIZE < 0.75 * myReader. get_sLevel ()) {
-	      std::complex<float> sample =
-	              myReader. getSample (coarseOffset + fineCorrector);
-	      envBuffer [syncBufferIndex] = jan_abs (sample);
-//	update the levels
-	      cLevel += envBuffer [syncBufferIndex] -
-	                envBuffer [(syncBufferIndex - C_LEVEL_SIZE) & syncBufferMask];
-	      syncBufferIndex = (syncBufferIndex + 1) & syncBufferMask;
-	      counter	++;
-//
-	      if (counter > T_null + 50) { // hopeless
-	         goto notSynced;
-	      }
-	   }
+	   if (!scanEnvelope (false, 0.75, T_null + 50))	// hopeless
+	      goto notSynced;
 /**
   *	The end of the null period is identified, the actual end
   *	is probably about 40 samples earlier.
@@ -211,7 +405,7 @@ SyncOnPhase:
 //
 //	and then, call upon the phase synchronizer to verify/compute
 //	the real "first" sample
-	   startIndex = phaseSynchronizer. findIndex (ofdmBuffer);
+	   startIndex = syncIndex ();
 	   if (startIndex < 0) { // no sync, try again
 	      if (!f2Correction) {
 	         setSyncLost ();
@@ -220,12 +414,14 @@ SyncOnPhase:
 	   }
 /**
   *	Once here, we are synchronized, we need to copy the data we
-  *	used for synchronization for block 0
+  *	used for synchronization for block 0. After an acquisition
+  *	(part of) the cyclic prefix is kept as well
   */
+	   prefix	= !acquired ? 0 : startIndex < T_g ? startIndex : T_g;
 	   memmove (ofdmBuffer. data (),
-	            &((ofdmBuffer. data ()) [startIndex]),
-	                  (T_u - startIndex) * sizeof (std::complex<float>));
-	   ofdmBufferIndex	= T_u - startIndex;
+	            &((ofdmBuffer. data ()) [startIndex - prefix]),
+	            (T_u - startIndex + prefix) * sizeof (std::complex<float>));
+	   ofdmBufferIndex	= T_u - startIndex + prefix;
 
 Block_0:
 /**
@@ -236,17 +432,32 @@ Block_0:
   *	We read the missing samples in the ofdm buffer
   */
 	   setSynced (true);
+	   if (probing)		// a probe wants each FIC frame
+	      my_ficHandler. fullRate ();
 	   myReader. getSamples (&((ofdmBuffer. data ()) [ofdmBufferIndex]),
-	                           T_u - ofdmBufferIndex,
+	                           T_u + prefix - ofdmBufferIndex,
 	                           coarseOffset + fineCorrector);
-	   my_ofdmDecoder. processBlock_0 (ofdmBuffer);
+	   if (acquired)
+	      seedOffsets (prefix);
+	   my_ofdmDecoder. processBlock_0 (&((ofdmBuffer. data ()) [prefix]));
 
 //	Here we look only at the block_0 when we need a coarse
 //	frequency synchronization.
 	   f2Correction	= !my_ficHandler. syncReached ();
-	   if (f2Correction) {
+#ifdef	__SYNC_STATISTICS
+	   if (acquisitionFrames >= 0) {
+	      if (!f2Correction) {
+	         fprintf (stderr, "acquisition: FIC in sync after %d frames\n",
+	                           acquisitionFrames);
+	         acquisitionFrames = -1;
+	      }
+	      else
+	         acquisitionFrames ++;
+	   }
+#endif
+	   if (f2Correction && !acquired) {
 	      int correction	=
-	            phaseSynchronizer. estimate_CarrierOffset (ofdmBuffer);
+	            phaseSynchronizer. estimate_CarrierOffset (ofdmBuffer. data ());
 	      if (correction != 100) {
 	         coarseOffset	+= correction * carrierDiff;
 	         if (abs (coarseOffset) > Khz (35))
@@ -266,30 +477,31 @@ Data_blocks:
 	   FreqCorr	= std::complex<float> (0, 0);
 	   for (ofdmSymbolCount = 1;
 	        ofdmSymbolCount < 4; ofdmSymbolCount ++) {
-	      myReader. getSamples (ofdmBuffer. data (),
-	                              T_s, coarseOffset + fineCorrector);
-	      for (i = (int)T_u; i < (int)T_s; i ++) 
-	         FreqCorr += ofdmBuffer [i] * conj (ofdmBuffer [i - T_u]);
+	      std::complex<float> *v =
+	                  my_ofdmDecoder. blockBuffer (ofdmSymbolCount);
+	      myReader. getSamples (v, T_s, coarseOffset + fineCorrector);
+	      FreqCorr += lagProduct (&v [T_u], v, T_g);
 
-	      my_ofdmDecoder. decodeFICblock (ofdmBuffer, ofdmSymbolCount);
+	      my_ofdmDecoder. decodeFICblock (v, ofdmSymbolCount);
 	   }
 
 ///	and similar for the (params -> L - 4) MSC blocks
 	   for (ofdmSymbolCount = 4;
 	        ofdmSymbolCount <  (uint16_t)nrBlocks;
 	        ofdmSymbolCount ++) {
-	      myReader. getSamples (ofdmBuffer. data (),
-	                              T_s, coarseOffset + fineCorrector);
-	      for (i = (int32_t)T_u; i < (int32_t)T_s; i ++) 
-	         FreqCorr += ofdmBuffer [i] * conj (ofdmBuffer [i - T_u]);
+	      std::complex<float> *v =
+	                  my_ofdmDecoder. blockBuffer (ofdmSymbolCount);
+	      myReader. getSamples (v, T_s, coarseOffset + fineCorrector);
+	      FreqCorr += lagProduct (&v [T_u], v, T_g);
 
-	      my_ofdmDecoder. decodeMscblock (ofdmBuffer, ofdmSymbolCount);
+	      if (!probing)
+	         my_ofdmDecoder. decodeMscblock (v, ofdmSymbolCount);
 	   }
 
 NewOffset:
 ///	we integrate the newly found frequency error with the
 ///	existing frequency error.
-	   fineCorrector += 0.1 * arg (FreqCorr) / (2 * M_PI) * carrierDiff;
+	   fineCorrector += 0.1 * fastArg (FreqCorr) / (2 * M_PI) * carrierDiff;
 //
 /**
   *	OK,  here we are at the end of the frame
@@ -314,8 +526,12 @@ NewOffset:
 	      fineCorrector += carrierDiff;
 	   }
 ReadyForNewFrame:
-///	and off we go, up to the next frame
-	   counter	= 0;
+///	and off we go, up to the next frame.
+///	The next block 0 will start (about) T_g samples into the
+///	buffer, after this frame we know the drift as well
+	   if (!tracking)
+	      expectedIndex	= T_g;
+	   tracking	= trackWindow > 0;
 	   goto SyncOnPhase;
 	}
 	catch (int e) {
@@ -401,6 +617,7 @@ void	dabProcessor::reset_msc (void) {
 void	dabProcessor::set_audioChannel (audiodata *d,
 	                                RingBuffer<int16_t> *b,
 	                                RingBuffer<uint8_t> *db) {
+	my_ficHandler. fullRate ();
 	my_mscHandler. set_audioChannel (d, b);
 	for (int i = 1; i < 10; i ++) {
            packetdata pd;
@@ -414,6 +631,7 @@ void	dabProcessor::set_audioChannel (audiodata *d,
 
 void	dabProcessor::set_dataChannel (packetdata *d,
 	                                      RingBuffer<uint8_t> *b) {
+	my_ficHandler. fullRate ();
 	my_mscHandler. set_dataChannel (d, b);
 }
 
@@ -422,6 +640,7 @@ QString dabProcessor::get_ensembleName	(void) {
 }
 
 void	dabProcessor::clearEnsemble	(void) {
+	my_ficHandler. fullRate ();
 	my_ficHandler. clearEnsemble ();
 }
 
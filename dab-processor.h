@@ -52,10 +52,15 @@ public:
 	                         uint8_t,
 	                         int16_t,
 	                         int16_t,
+	                         int16_t,
+	                         int16_t,
+	                         bool,
+	                         int16_t,
 	                         QString);
 		~dabProcessor	(void);
 	void		reset			(void);
 	void		start			(int, bool);
+	void		startProbe		(int);
 	void		stop			(void);
 	void		setOffset		(int32_t);
 	void		coarseCorrectorOn	(void);
@@ -93,6 +98,7 @@ private:
 
 	int16_t		attempts;
 	bool		giveSignal;
+	bool		probing;
 	int32_t		T_null;
 	int32_t		T_u;
 	int32_t		T_s;
@@ -112,12 +118,38 @@ private:
 	uint32_t	ofdmSymbolCount;
 	phaseReference	phaseSynchronizer;
 	ofdmDecoder	my_ofdmDecoder;
+	std::vector<float>	envBuffer;
+	int32_t		syncBufferIndex;
+	float		cLevel;
+	bool		scanEnvelope		(bool, double, int32_t);
+//
+//	tracking of the start of block 0 once in sync
+	int16_t		trackWindow;
+	int16_t		trackMisses;
+	bool		tracking;
+	int16_t		missCount;
+	int32_t		expectedIndex;
+	int32_t		syncIndex		(void);
+//
+//	acquisition of time and frequency from a single block 0
+	bool		acquisition;
+	bool		acquired;
+	float		carrierOffset;
+	void		seedOffsets		(int32_t);
+#ifdef	__SYNC_STATISTICS
+	double		syncTime;
+	int32_t		syncFrames;
+	int32_t		fullSearches;
+	int32_t		syncMisses;
+	int32_t		acquisitionFrames;
+#endif
 	bool		wasSecond		(int16_t, dabParams *);
 virtual	void		run			(void);
 	bool		isReset;
 signals:
 	void		setSynced		(char);
 	void		No_Signal_Found		(void);
+	void		ensembleComplete	(void);
 	void		setSyncLost		(void);
 	void		showCoordinates		(int, int);
 //	void		showCoordinates		(float, float);
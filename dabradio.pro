@@ -65,12 +65,16 @@ HEADERS += ./radio.h \
 	   ./includes/dab-constants.h \
 	   ./includes/country-codes.h \
 	   ./includes/ofdm/sample-reader.h \
+	   ./includes/ofdm/sample-kernels.h \
+	   ./includes/ofdm/demod-kernels.h \
 	   ./includes/ofdm/ofdm-decoder.h \
 	   ./includes/ofdm/phasereference.h \
 	   ./includes/ofdm/phasetable.h \
 	   ./includes/ofdm/freq-interleaver.h \
 #	   ./includes/backend/viterbi.h \
 	   ./includes/backend/viterbi_768/viterbi-768.h \
+	   ./src/backend/viterbi_768/spiral-sse.h \
+	   ./src/backend/viterbi_768/spiral-no-sse.h \
 	   ./includes/backend/fic-handler.h \
 	   ./includes/backend/msc-handler.h \
 	   ./includes/backend/fib-processor.h  \
@@ -94,6 +98,7 @@ HEADERS += ./radio.h \
 	   ./includes/backend/data/mot-object.h \
 	   ./includes/backend/protection.h \
 	   ./includes/backend/eep-protection.h \
+	   ./includes/backend/time-deinterleaver.h \
 	   ./includes/backend/uep-protection.h \
 #	   ./includes/output/fir-filters.h \
 	   ./includes/output/audio-base.h \
@@ -101,8 +106,10 @@ HEADERS += ./radio.h \
 	   ./includes/output/audiosink.h \
            ./includes/various/fft-handler.h \
 	   ./includes/various/ringbuffer.h \
+	   ./includes/various/event-count.h \
 	   ./includes/various/Xtan2.h \
 	   ./includes/various/dab-params.h \
+	   ./includes/various/cpu-features.h \
 	   ./includes/various/band-handler.h \
 	   ./includes/various/text-mapper.h \
 	   ./devices/virtual-input.h \
@@ -117,21 +124,25 @@ SOURCES += ./main.cpp \
 	   ./service-list.cpp \
 	   ./service-display.cpp \
 	   ./src/ofdm/sample-reader.cpp \
+	   ./src/ofdm/sample-kernels.cpp \
+	   ./src/ofdm/demod-kernels.cpp \
 	   ./src/ofdm/ofdm-decoder.cpp \
 	   ./src/ofdm/phasereference.cpp \
 	   ./src/ofdm/phasetable.cpp \
 	   ./src/ofdm/freq-interleaver.cpp \
 #	   ./src/backend/viterbi.cpp \
 	   ./src/backend/viterbi_768/viterbi-768.cpp \
+	   ./src/backend/viterbi_768/spiral-sse.c \
+	   ./src/backend/viterbi_768/spiral-no-sse.c \
 	   ./src/backend/fic-handler.cpp \
 	   ./src/backend/msc-handler.cpp \
 	   ./src/backend/protection.cpp \
 	   ./src/backend/eep-protection.cpp \
+	   ./src/backend/time-deinterleaver.cpp \
 	   ./src/backend/uep-protection.cpp \
 	   ./src/backend/fib-processor.cpp  \
 	   ./src/backend/galois.cpp \
 	   ./src/backend/reed-solomon.cpp \
-	   ./src/backend/rscodec.cpp \
 	   ./src/backend/charsets.cpp \
 	   ./src/backend/firecode-checker.cpp \
 	   ./src/backend/frame-processor.cpp \
@@ -155,6 +166,7 @@ SOURCES += ./main.cpp \
            ./src/various/fft-handler.cpp \
 	   ./src/various/Xtan2.cpp \
 	   ./src/various/dab-params.cpp \
+	   ./src/various/cpu-features.cpp \
 	   ./src/various/band-handler.cpp \
 	   ./src/various/text-mapper.cpp \
 	   ./devices/virtual-input.cpp \
@@ -207,16 +219,17 @@ CONFIG		+= airspy
 #when this one is enabled, load is spread over different threads
 DEFINES	+= __THREADED_BACKEND
 #DEFINES	+= __THREADED_DECODING
+#DEFINES	+= __DECODER_TIMINGS
+#DEFINES	+= __SYNC_STATISTICS
 
 #and this one is experimental
 DEFINES		+= PRESET_NAME
 
 #and these one is just experimental,
-#NO_SSE is always safe
+#on x86 the SSE2 and AVX2 kernels are always there, the one
+#to use is found at startup. For NEON enable one of
 #CONFIG	+= NEON_RPI2
 #CONFIG	+= NEON_RPI3
-#CONFIG	+= SSE
-CONFIG	+= NO_SSE
 }
 #
 # an attempt to have it run under W32 through cross compilation
@@ -259,13 +272,14 @@ CONFIG		+= airspy
 CONFIG		+= dabstick
 CONFIG		+= sdrplay
 
-CONFIG		+= NO_SSE
 
 
 #for the raspberry you definitely want this one
 #when this one is enabled, load is spread over different threads
 DEFINES	+= __THREADED_BACKEND
 #DEFINES	+= __THREADED_DECODING
+#DEFINES	+= __DECODER_TIMINGS
+#DEFINES	+= __SYNC_STATISTICS
 
 
 #and this one is experimental
@@ -359,14 +373,4 @@ NEON_RPI3	{
 	SOURCES		+= ./src/backend/viterbi_768/spiral-neon.c
 }
 
-SSE	{
-	DEFINES		+= SSE_AVAILABLE
-	HEADERS		+= ./src/backend/viterbi_768/spiral-sse.h
-	SOURCES		+= ./src/backend/viterbi_768/spiral-sse.c
-}
-
-NO_SSE	{
-	HEADERS		+= ./src/backend/viterbi_768/spiral-no-sse.h
-	SOURCES		+= ./src/backend/viterbi_768/spiral-no-sse.c
-}
 
@@ -287,6 +287,7 @@ int32_t  i, j;
 	         }
 
 	         theBuffer	-> putDataIntoBuffer (temp, 2048);
+	         signalSamples ();
 //
 //	shift the sample at the end to the beginning, it is needed
 //	as the starting sample for the next time
@@ -309,6 +310,7 @@ int32_t  i, j;
 	      }
 
 	      theBuffer	-> putDataIntoBuffer (temp, 2048);
+	      signalSamples ();
 //
 //	shift the sample at the end to the beginning, it is needed
 //	as the starting sample for the next time
@@ -43,6 +43,7 @@ int	i;
 	this	-> theRate	= 3072000;
 	this	-> defaultFreq	= defaultFreq;
 	this	-> functions	= f;
+	this	-> theHandler	= h;
 	this	-> theBuffer	= theBuffer;
 	*OK			= false;	// just the default
 	iqSwitch		= false;
@@ -252,6 +253,7 @@ int	rc, i;
                     }
 
                     theBuffer -> putDataIntoBuffer (temp, 2048);
+	            theHandler -> signalSamples ();
 //      shift the sample at the end to the beginning, it is needed
 //      as the starting sample for the next time
 	            convBuffer [0] = convBuffer [convBufferSize];
@@ -52,6 +52,7 @@ public:
 private:
 	void			run	(void);
 	eladLoader		*functions;	// 
+	eladHandler		*theHandler;
 	RingBuffer<uint8_t>	*_I_Buffer;
 	RingBuffer<std::complex<float>>	*theBuffer;
 	int32_t			defaultFreq;
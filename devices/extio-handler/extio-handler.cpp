@@ -53,8 +53,10 @@ extioHandler	*myContext	= NULL;
 static
 int	extioCallback (int cnt, int status, float IQoffs, void *IQData) {
 	if (cnt > 0) { 	//	we got data
-	   if (myContext != NULL && myContext -> isStarted) 
+	   if (myContext != NULL && myContext -> isStarted) {
 	      myContext -> theReader -> processData (IQoffs, IQData, cnt);
+	      myContext -> signalSamples ();
+	   }
 	}
 	else	// we got something 
 	if (cnt < 0) {
@@ -177,6 +177,7 @@ RingBuffer<std::complex<float> > * q = ctx -> _I_Buffer;
 	   buffer [i]	= std::complex<float> (re, im);
 	}
 	q	-> putDataIntoBuffer (buffer, transfer -> valid_length / 2);
+	ctx	-> signalSamples ();
 	return 0;
 }
 
@@ -96,11 +96,9 @@ uint8_t	*temp = (uint8_t *)alloca (2 * size * sizeof (uint8_t));
 	if (filePointer == NULL)
 	   return 0;
 
+//	the reader thread signals when it added data
 	while ((int32_t)(_I_Buffer -> GetRingBufferReadAvailable ()) < 2 * size)
-	   if (readerPausing)
-	      usleep (100000);
-	   else
-	      msleep (100);
+	   waitForSamples (size, 100);
 
 	amount = _I_Buffer	-> getDataFromBuffer (temp, 2 * size);
 	for (i = 0; i < amount / 2; i ++)
@@ -149,6 +147,7 @@ int64_t	nextStop;
 	      t = bufferSize;
 	   }
 	   _I_Buffer -> putDataIntoBuffer (bi, t);
+	   signalSamples ();
 	   if (nextStop - getMyTime () > 0)
 	      usleep (nextStop - getMyTime ());
 	}
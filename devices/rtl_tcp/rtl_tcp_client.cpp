@@ -217,6 +217,7 @@ uint8_t	buffer [8192];
 	   toServer. read ((char *)buffer, 8192);
 	   theBuffer -> putDataIntoBuffer (buffer, 8192);
 	}
+	signalSamples ();
 }
 //
 //
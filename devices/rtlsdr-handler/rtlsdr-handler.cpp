@@ -50,6 +50,7 @@ rtlsdrHandler	*theStick	= (rtlsdrHandler *)ctx;
 	   return;
 
 	(void)theStick -> _I_Buffer -> putDataIntoBuffer (buf, len);
+	theStick	-> signalSamples ();
 }
 //
 //	for handling the events in libusb, we need a controlthread
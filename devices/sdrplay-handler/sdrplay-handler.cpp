@@ -257,6 +257,7 @@ std::complex<float> *localBuf =
 	   localBuf [i] = std::complex<float> (float (xi [i]) / denominator,
 	                                       float (xq [i]) / denominator);
 	p -> _I_Buffer -> putDataIntoBuffer (localBuf, numSamples);
+	p -> signalSamples ();
 	(void)	firstSampleNum;
 	(void)	grChanged;
 	(void)	rfChanged;
@@ -77,6 +77,7 @@ void	uhd_streamer::run (void) {
 	   size_t num_rx_samps =
 	         m_theStick -> m_rx_stream -> recv (data1, size1, md, 1.0);
 	   m_theStick -> theBuffer -> AdvanceRingBufferWriteIndex (num_rx_samps);
+	   m_theStick -> signalSamples ();
 
 	   if (md.error_code == uhd::rx_metadata_t::ERROR_CODE_TIMEOUT) {
 	      std::cout << boost::format ("Timeout while streaming") << std::endl;
@@ -63,5 +63,24 @@ int32_t	virtualInput::defaultFrequency	(void) {
 
 void	virtualInput::resetBuffer	(void) {
 }
+//
+//	The test on Samples () is done while holding the lock, and
+//	signalSamples needs the lock to wake up the waiting thread,
+//	so a signal cannot get lost between the test and the wait.
+//	The timeout is a safety net only, e.g. for devices that
+//	do not signal and for stopping the waiting thread.
+bool	virtualInput::waitForSamples	(int32_t n, int32_t msecs) {
+	sampleLocker. lock ();
+	if (Samples () < n)
+	   sampleArrived. wait (&sampleLocker, msecs);
+	sampleLocker. unlock ();
+	return Samples () >= n;
+}
+
+void	virtualInput::signalSamples	(void) {
+	sampleLocker. lock ();
+	sampleArrived. wakeAll ();
+	sampleLocker. unlock ();
+}
 
 
@@ -29,6 +29,8 @@
 #include	<stdint.h>
 #include	"dab-constants.h"
 #include	<QObject>
+#include	<QMutex>
+#include	<QWaitCondition>
 
 class	virtualInput: public QObject {
 public:
@@ -46,8 +48,17 @@ virtual		int16_t	bitDepth	(void) { return 10;}
 virtual		void	set_Gain	(int) {}
 virtual		void	set_autoGain	(bool) {}
 //
+//	waitForSamples blocks the caller until at least n samples
+//	are available, or msecs milliseconds have passed.
+//	Producers (callbacks, reader threads) call signalSamples
+//	after adding samples to their buffer
+		bool	waitForSamples	(int32_t n, int32_t msecs);
+		void	signalSamples	(void);
 protected:
 		int32_t	lastFrequency;
+private:
+		QMutex		sampleLocker;
+		QWaitCondition	sampleArrived;
 };
 #endif
 
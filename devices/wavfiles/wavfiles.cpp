@@ -104,11 +104,9 @@ int32_t	amount;
 	if (filePointer == NULL)
 	   return 0;
 
+//	the reader thread signals when it added data
 	while (_I_Buffer -> GetRingBufferReadAvailable () < size)
-	   if (readerPausing)
-	      usleep (100000);
-	   else
-	      usleep (100);
+	   waitForSamples (size, 100);
 
 	amount = _I_Buffer	-> getDataFromBuffer (V, size);
 	
@@ -155,6 +153,7 @@ int64_t	nextStop;
 	      t = bufferSize;
 	   }
 	   _I_Buffer -> putDataIntoBuffer (bi, bufferSize);
+	   signalSamples ();
 	   if (nextStop - getMyTime () > 0)
 	      usleep (nextStop - getMyTime ());
 	}
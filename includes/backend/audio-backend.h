@@ -35,6 +35,7 @@
 
 class	frameProcessor;
 class	protection;
+class	timeDeinterleaver;
 class	RadioInterface;
 
 #ifdef	__THREADED_BACKEND
@@ -48,7 +49,7 @@ public:
 	                 RingBuffer<int16_t> *,
 	                 QString	picturesPath);
 	~audioBackend	(void);
-int32_t	process		(int16_t *, int16_t);
+int32_t	process		(int8_t *, int16_t);
 void	stopRunning	(void);
 protected:
 	RadioInterface	*myRadioInterface;
@@ -59,11 +60,11 @@ void	run		(void);
 	atomic<bool>	running;
 	QSemaphore	freeSlots;
 	QSemaphore	usedSlots;
-	int16_t		*theData [20];
+	int8_t		*theData [20];
 	int16_t		nextIn;
 	int16_t		nextOut;
 #endif
-void	processSegment	(int16_t *Data);
+void	processSegment	(int8_t *Data);
 
 	uint8_t		dabModus;
 	int16_t		fragmentSize;
@@ -71,10 +72,8 @@ void	processSegment	(int16_t *Data);
 	bool		shortForm;
 	int16_t		protLevel;
 	std::vector<uint8_t> outV;
-	int16_t		**interleaveData;
-	std::vector<int16_t> tempX;
-	int16_t		countforInterleaver;
-	int16_t		interleaverIndex;
+	timeDeinterleaver	*deinterleaver;
+	std::vector<int8_t> tempX;
 	std::vector<uint8_t> disperseVector;
 
 	protection	*protectionHandler;
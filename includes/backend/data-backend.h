@@ -35,6 +35,7 @@
 class	dataProcessor;
 class	RadioInterface;
 class	protection;
+class	timeDeinterleaver;
 
 class	dataBackend:public QThread, public virtualBackend {
 Q_OBJECT
@@ -44,7 +45,7 @@ public:
 	                 RingBuffer<uint8_t> *dataBuffer,
 	                 QString	picturesPath);
 	~dataBackend	(void);
-int32_t	process		(int16_t *, int16_t);
+int32_t	process		(int8_t *, int16_t);
 void	stopRunning	(void);
 private:
 	RadioInterface	*myRadioInterface;
@@ -55,16 +56,15 @@ private:
 	std::vector<uint8_t> disperseVector;
 void	run		(void);
 	volatile bool	running;
-	int32_t		countforInterleaver;
 	uint8_t		* outV;
-	int16_t		**interleaveData;
+	timeDeinterleaver	*deinterleaver;
 	int16_t		*Data;
 	protection	*protectionHandler;
 	RingBuffer<int16_t>	*Buffer;
 	dataProcessor	*our_frameProcessor;
 	QSemaphore      freeSlots;
 	QSemaphore      usedSlots;
-	int16_t         *theData [20];
+	int8_t          *theData [20];
 	int16_t         nextIn;
 	int16_t         nextOut;
         int		fragmentSize;
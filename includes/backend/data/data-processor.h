@@ -56,6 +56,7 @@ private:
 	RingBuffer<uint8_t>* dataBuffer;
 	int16_t		expectedIndex;
 	std::vector<uint8_t>	series;
+	std::vector<uint8_t>	bits;
 	uint8_t		packetState;
 	int32_t		streamAddress;		// int since we init with -1
 //
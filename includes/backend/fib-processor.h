@@ -119,6 +119,9 @@ public:
 protected:
 	void	newFrame		(void);
 	void	process_FIB		(uint8_t *, uint16_t);
+//	set when a FIG 0/0 announces a change in the configuration
+	bool	changeAnnounced;
+	void	checkEnsemble		(void);
 private:
 	RadioInterface	*myRadioInterface;
 	serviceId	*findServiceId (int32_t);
@@ -179,10 +182,14 @@ private:
 	bool		dateFlag;
 	bool		isSynced;
 	QMutex		fibLocker;
+	int16_t		ensembleItems;
+	int16_t		quietFrames;
+	bool		ensembleReported;
 signals:
 	void		addtoEnsemble	(const QString &);
 	void		nameofEnsemble  (int, const QString &);
 	void		changeinConfiguration (void);
+	void		ensembleComplete (void);
 };
 
 #endif
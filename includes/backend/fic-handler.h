@@ -29,11 +29,15 @@
 #include	<stdio.h>
 #include	<stdint.h>
 #include	<vector>
+#include	<atomic>
 #include	"viterbi-768.h"
 #include	<QObject>
 #include	"fib-processor.h"
 #include	"dab-params.h"
-
+//
+//	the number of frames in a row with all FIBs correct before
+//	the FIC is decoded in only one of each dutyCycle frames
+#define	STABLE_FRAMES	50
 
 class	RadioInterface;
 
@@ -42,17 +46,20 @@ Q_OBJECT
 public:
 		ficHandler		(RadioInterface *, uint8_t);
 		~ficHandler		(void);
-	void	process_ficBlock	(std::vector<int16_t>, int16_t);
+	void	process_ficBlock	(int8_t *, int16_t);
 	void	stop			(void);
 	void	reset			(void);
+	void	setDutyCycle		(int16_t);
+	bool	frameNeeded		(void);
+	void	fullRate		(void);
 private:
 	viterbi_768	myViterbi;
 	dabParams	params;
-	uint8_t		bitBuffer_out	[768];
-        int16_t		ofdm_input	[2304];
-	bool		punctureTable	[3072 + 24];
+	uint8_t		bitBuffer_out	[4][768];
+        int8_t		ofdm_input	[4][2304];
+	struct puncturing	punctures;
 
-	void		process_ficInput	(int16_t);
+	void		decodeFrame		(int16_t);
 	int16_t		index;
 	int16_t		BitsperBlock;
 	int16_t		ficno;
@@ -62,6 +69,20 @@ private:
 	uint16_t	convState;
 	uint8_t		PRBS		[768];
 	uint8_t		shiftRegister	[9];
+//
+//	duty cycling, frameCount is only touched by the thread asking
+//	frameNeeded, the others by the one doing the decoding
+	int16_t		dutyCycle;
+	int32_t		frameCount;
+	std::atomic<bool>	steady;
+	std::atomic<int16_t>	goodFrames;
+	bool		frameCorrect;
+	void		endofFrame		(void);
+#ifdef	__DECODER_TIMINGS
+	int32_t		decodedFrames;
+	int32_t		skippedFrames;
+	double		decodeTime;
+#endif
 signals:
 	void		show_ficSuccess	(bool);
 };
@@ -34,7 +34,11 @@ class	frameProcessor {
 public:
 		frameProcessor	(void);
 virtual		~frameProcessor	(void);
-virtual	void	addtoFrame	(std::vector<uint8_t>);
+//
+//	the argument points to 24 * bitRate bits, packed in bytes with
+//	the first bit as msb, owned by the caller and only valid during
+//	the call
+virtual	void	addtoFrame	(uint8_t *);
 };
 #endif
 
@@ -42,7 +42,13 @@ public:
 	                                         uint8_t,
 	                                         QString);
 			~mscHandler		(void);
-	void		process_mscBlock	(std::vector<int16_t>, int16_t);
+//
+//	the softbits of a block no backend needs may be passed as NULL
+	void		process_mscBlock	(int8_t *, int16_t);
+//
+//	tells whether the data of block blkno (4 .. L - 1) will be used
+//	by one of the current backends, may be called from any thread
+	bool		blockNeeded		(int16_t blkno);
 	void		set_audioChannel	(audiodata *,
 	                                           RingBuffer<int16_t> *);
 	void		set_dataChannel         (packetdata *,
@@ -62,7 +68,7 @@ private:
 	QMutex		locker;
 	bool		audioService;
 	std::vector<virtualBackend *>theBackends;
-	std::vector<int16_t> cifVector;
+	std::vector<int8_t> cifVector;
 	int16_t		cifCount;
 	int16_t		blkCount;
 	std::atomic<bool> work_to_be_done;
@@ -83,6 +89,8 @@ private:
 	int16_t		BitsperBlock;
 	int16_t		numberofblocksperCIF;
 	int16_t		blockCount;
+	std::atomic<bool>	*neededBlocks;
+	void		setNeededBlocks		(void);
 
 	int16_t		**interleaveData;
 	int16_t		interleaverIndex;
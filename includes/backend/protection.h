@@ -30,17 +30,22 @@
 #include        "viterbi-768.h"
 
 extern uint8_t	PI_X [];
+//
+//	the subchannels are decoded with a windowed traceback, with
+//	this depth the decoded bits equal the ones of a traceback
+//	over the whole codeword, also at a bit error rate of 3 %
+#define	TRACEBACK_DEPTH	192
 
 class   protection: public viterbi_768 {
 public:
                 protection      (int16_t, int16_t);
 virtual         ~protection     (void);
-virtual bool    deconvolve      (int16_t *, int32_t, uint8_t *);
+//	the 24 * bitRate bits come out packed, msb first
+virtual bool    deconvolve      (int8_t *, int32_t, uint8_t *);
 protected:
         int16_t         bitRate;
         int32_t         outSize;
-        std::vector<int16_t> viterbiBlock;
-	std::vector<uint8_t> indexTable;
+	struct puncturing punctures;
 };
 
 #endif
@@ -20,7 +20,15 @@ private:
 	uint8_t fcr;		/* First consecutive root, index form */
 	uint8_t prim;		/* Primitive element, index form */
 	uint8_t iprim;		/* prim-th root of 1, index form */
+	uint8_t	kernel;
+//	per root, the products with all symbols, and for the
+//	SIMD version the products with the low and high nibbles
+	uint8_t	*rootProducts;
+	uint8_t	*nibbleProducts;
 	bool	computeSyndromes	(uint8_t *, uint8_t *);
+	void	batchSyndromes		(const uint8_t *, int16_t,
+	                                 int16_t, uint8_t *);
+	int16_t	correctErrors		(uint8_t *, uint8_t *);
 	uint8_t	getSyndrome		(uint8_t *, uint8_t);
 	uint16_t computeLambda		(uint8_t *, uint8_t *);
 	int16_t	computeErrors		(uint8_t *, uint16_t,
@@ -37,6 +45,12 @@ public:
 	                     uint16_t nroots	= 10);
 		~reedSolomon (void);
 int16_t		dec	  (const uint8_t *data_in, uint8_t *data_out, int16_t cutlen);
+//
+//	n codewords, interleaved as in a DAB+ superframe: symbol k of
+//	codeword j is data [j + k * n]. They are corrected in place,
+//	the result is -1 if one of them cannot be, otherwise the
+//	number of corrected symbols
+int16_t		decBatch  (uint8_t *data, int16_t n, int16_t cutlen);
 void		enc	  (const uint8_t *data_in, uint8_t *data_out, int16_t cutlen);
 };
 
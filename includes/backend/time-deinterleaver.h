@@ -0,0 +1,57 @@
+#
+/*
+ *    Copyright (C) 2013 .. 2017
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#
+#ifndef	__TIME_DEINTERLEAVER__
+#define	__TIME_DEINTERLEAVER__
+/*
+ *	The time de-interleaving of a subchannel (DAB standard 12),
+ *	shared by the audio and the data backend.
+ *	The soft bits of the last 16 CIF's are kept in one delay
+ *	line. Per group of 32 positions there is a block of 16 rows,
+ *	one for each CIF, of 32 soft bits. Storing a CIF is storing
+ *	one row per block, the soft bits coming out are picked from
+ *	the 16 rows of the block with a mask per row, on x86 with
+ *	SSE2 or - when the cpu has it - AVX2
+ */
+#include	<stdint.h>
+
+#define	DEINTERLEAVE_GROUP	32
+
+class	timeDeinterleaver {
+public:
+		timeDeinterleaver	(int32_t);
+		~timeDeinterleaver	(void);
+//
+//	in and out have size soft bits, the result is false as long as
+//	the delay line is not filled, i.e. for the first 16 CIF's
+	bool	process			(const int8_t *in, int8_t *out);
+private:
+	int32_t	size;
+	int32_t	groups;
+	int8_t	*delayLine;
+	int16_t	index;
+	int16_t	count;
+	uint8_t	kernel;
+	int8_t	*masks;
+};
+#endif
+
@@ -35,7 +35,7 @@ class	virtualBackend {
 public:
 		virtualBackend	(int32_t, int16_t);
 virtual		~virtualBackend	(void);
-virtual int32_t	process		(int16_t *, int16_t);
+virtual int32_t	process		(int8_t *, int16_t);
 virtual void	stopRunning	(void);
 virtual	void	stop		(void);
 	int32_t	startAddr	(void);
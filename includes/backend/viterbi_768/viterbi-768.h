@@ -27,6 +27,23 @@ typedef union {
 	COMPUTETYPE t[NUMSTATES];
 } metric_t __attribute__ ((aligned (16)));
 
+//	A puncturing scheme, as a sequence of runs over the mother
+//	code. In a run of length soft bits the 32 bit pattern repeats,
+//	bit j set tells that position j (mod 32) was transmitted.
+//	The DAB schemes (FIC, EEP and UEP) have at most 5 runs
+#define	MAX_RUNS	8
+struct puncturing {
+	int16_t	nrRuns;
+	struct {
+	   int32_t	length;
+	   uint32_t	pattern;
+	} runs [MAX_RUNS];
+};
+//
+//	append a run of length bits, PI is one of the 32 entry
+//	puncturing vectors of the standard (see protTables)
+void	addRun	(struct puncturing *, int32_t length, const int8_t *PI);
+
 /* State info for instance of Viterbi decoder
  */
 
@@ -42,14 +59,26 @@ struct v {
 
 class	viterbi_768 {
 public:
-		viterbi_768	(int16_t, bool spiral = false);
+		viterbi_768	(int16_t, bool spiral = false,
+	                                  int16_t depth = 0);
 		~viterbi_768	(void);
-	void	deconvolve	(int16_t *, uint8_t *);
+	void	deconvolve	(int8_t *, uint8_t *);
+	void	deconvolve	(int8_t *,
+	                         const struct puncturing *, uint8_t *);
+	void	deconvolve	(int8_t **, const struct puncturing *,
+	                         uint8_t **, int16_t);
+//	the same, with the bits packed, msb first, in frameBits / 8 bytes
+	void	deconvolvePacked (int8_t *,
+	                         const struct puncturing *, uint8_t *);
+	int32_t	footprint	(void);
 private:
 
 	bool		spiral;
+	uint8_t		kernel;
 	struct v	vp;
 	COMPUTETYPE Branchtab	[NUMSTATES / 2 * RATE] __attribute__ ((aligned (16)));
+//	the same table, for the 16 bit metrics of the SIMD code
+	int16_t	Branchtab16	[NUMSTATES / 2 * RATE] __attribute__ ((aligned (16)));
 //	int	parityb		(uint8_t);
 	int	parity		(int);
 	void	partab_init	(void);
@@ -59,7 +88,21 @@ private:
 	                                         int16_t);
 	void	update_viterbi_blk_SPIRAL	(struct v *, COMPUTETYPE *,
 	                                         int16_t);
+	void	update_viterbi_blk_SSE2		(struct v *, COMPUTETYPE *,
+	                                         int16_t);
+	void	update_viterbi_blk_AVX2		(struct v *, COMPUTETYPE *,
+	                                         int16_t);
 	void	chainback_viterbi (struct v *, uint8_t *, int16_t, uint16_t);
+	void	decodeBatch	(int8_t **, const struct puncturing *,
+	                         uint8_t **, int16_t, bool);
+	void	decodeWord	(int8_t *,
+	                         const struct puncturing *, uint8_t *, bool);
+	void	startSymbols	(int8_t *, const struct puncturing *);
+	void	nextSymbols	(COMPUTETYPE *, int32_t);
+	void	updateMetrics	(int16_t);
+	void	traceback	(uint16_t, int32_t, int32_t, int32_t,
+	                         uint8_t *, bool);
+	uint16_t bestState	(void);
 	struct v *viterbi_alloc (int32_t);
 	void	BFLY		(int32_t, int, COMPUTETYPE *,
 	                         struct v *, decision_t *);
@@ -67,6 +110,21 @@ private:
 	uint8_t *data;
 	COMPUTETYPE *symbols;
 	int16_t	frameBits;
+	int16_t	depth;
+	int16_t	window;
+	int32_t	ringSize;
+	int32_t	symbolSteps;
+	decision_t	*decisionBase;
+//	the cursor of nextSymbols
+	int8_t	*symbolInput;
+	const struct puncturing *symbolPunctures;
+	int16_t	symbolRun;
+	int32_t	symbolPos;
+#ifdef	__DECODER_TIMINGS
+	double	decodeTime;
+	int32_t	decodeWords;
+	int32_t	decodeCount;
+#endif
 };
 
 #endif
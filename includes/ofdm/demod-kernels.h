@@ -0,0 +1,64 @@
+#
+/*
+ *    Copyright (C) 2013 .. 2017
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#
+#ifndef	__DEMOD_KERNELS__
+#define	__DEMOD_KERNELS__
+/*
+ *	The differential demodulation of an ofdm symbol.
+ *	On x86 both the SSE2 and the AVX2 variant are compiled in, and
+ *	demodulatorFor picks one depending on the cpu, elsewhere it is
+ *	plain C++
+ */
+#include	<stdint.h>
+#include	<complex>
+
+//
+//	For carrier i (0 <= i < carriers), with k = bins [i],
+//	r = v [k] * conj (ref [k]), and the soft bits are
+//	ibits [i]		= - real (r) / jan_abs (r) * 127
+//	ibits [carriers + i]	= - imag (r) / jan_abs (r) * 127
+//	truncated, the result is bit identical for all variants.
+//	The soft bits are in -127 .. 127, so they fit in a byte
+void	demodulate	(const std::complex<float> *v,
+	                 const std::complex<float> *ref,
+	                 const int32_t *bins,
+	                 int8_t *ibits, int32_t carriers);
+//
+//	demodulate, specialized for the number of carriers of a mode
+//	(I, II or IV). For other modes it is the general one, the
+//	carriers parameter should be the right one anyway
+typedef	void	(*demodulator)	(const std::complex<float> *,
+	                         const std::complex<float> *,
+	                         const int32_t *,
+	                         int8_t *, int32_t);
+demodulator	demodulatorFor	(uint8_t dabMode);
+//
+//	d [i] = abs (arg (x [i] * conj (x [i + 1]))), for 0 <= i < n,
+//	the arctangent is approximated by a polynomial, the error
+//	is less than 2e-6 radians
+void	absPhaseDiffs	(const std::complex<float> *x,
+	                 float *d, int32_t n);
+//
+//	arg (v), with the same polynomial
+float	fastArg		(std::complex<float> v);
+#endif
+
@@ -25,10 +25,8 @@
 #include	"dab-constants.h"
 #ifdef	__THREADED_DECODING
 #include	<QThread>
-#include	<QWaitCondition>
-#include	<QMutex>
-#include	<QSemaphore>
 #include	<atomic>
+#include	"event-count.h"
 #else
 #include	<QObject>
 #endif
@@ -39,10 +37,22 @@
 #include	"phasetable.h"
 #include	"freq-interleaver.h"
 #include	"dab-params.h"
+#include	"demod-kernels.h"
+
+//
+//	MSC blocks no backend asks for, and FIC blocks of frames the
+//	ficHandler does not want, are not transformed, unless
+//	they are the phase reference for a block that is asked for
+#define	BLOCK_SKIPPED	0
+#define	BLOCK_REFERENCE	1
+#define	BLOCK_DATA	2
 
 class	RadioInterface;
 class	ficHandler;
 class	mscHandler;
+#ifdef	__THREADED_DECODING
+class	fftWorker;
+#endif
 
 #ifdef	__THREADED_DECODING
 class	ofdmDecoder: public QThread {
@@ -57,33 +67,75 @@ public:
 	                                 ficHandler	*,
 	                                 mscHandler	*);
 		~ofdmDecoder		(void);
-	void	processBlock_0		(std::vector<std::complex<float> >);
-	void	decodeFICblock		(std::vector<std::complex<float> >, int32_t n);
-	void	decodeMscblock		(std::vector<std::complex<float> >, int32_t n);
+//
+//	The data is passed as a pointer to (at least) T_s samples,
+//	preferably the one obtained from blockBuffer, since then
+//	no copying is needed
+	std::complex<float>	*blockBuffer	(int32_t);
+	void	processBlock_0		(std::complex<float> *);
+	void	decodeFICblock		(std::complex<float> *, int32_t n);
+	void	decodeMscblock		(std::complex<float> *, int32_t n);
 	int16_t	get_snr			(std::complex<float> *);
+	void	start			(void);
 	void	stop			(void);
 	void	reset			(void);
-#ifndef	__THREADED_DECODING
-	void	start			(void);
-#endif
 private:
 	RadioInterface	*myRadioInterface;
 	dabParams	params;
 	fftHandler	my_fftHandler;
 	ficHandler	*my_ficHandler;
 	mscHandler	*my_mscHandler;
+	void		toBits		(std::complex<float> *,
+	                                 std::complex<float> *);
+	uint8_t		blockUse	(int32_t);
+	bool		ficFrame;
 #ifdef	__THREADED_DECODING
+friend	class	fftWorker;
+	void		handleBits	(int32_t);
 	void		run		(void);
-	std::atomic<bool>		running;
-	std::complex<float>	**command;
-	int16_t		amount;
-	int16_t		currentBlock;
-	void		processBlock_0		(void);
-	void		decodeFICblock		(int32_t n);
-	void		decodeMscblock		(int32_t n);
-	QSemaphore	bufferSpace;
-	QWaitCondition	commandHandler;
-	QMutex		helper;
+	void		enterBlock	(std::complex<float> *, int32_t);
+	bool		transformNext	(void);
+	void		reportTimings	(void);
+	std::atomic<bool>	running;
+	int16_t		nrWorkers;
+	std::vector<fftWorker *>	workers;
+//
+//	The symbols are kept in a ring of slots, indexed by sequence
+//	number modulo nrSlots. The producer (the dabProcessor thread)
+//	fills slots, the workers claim filled slots (through "claimed")
+//	and do the FFT, the decoder thread itself demodulates the
+//	slots in order and frees them
+	int32_t		nrSlots;
+	std::complex<float>	**slot;
+	int32_t		*slotBlock;
+	uint8_t		*slotUse;
+	std::atomic<int32_t>	*slotDone;
+	std::atomic<int64_t>	produced;
+	std::atomic<int64_t>	claimed;
+	std::atomic<int64_t>	released;
+	eventCount	spaceEvent;
+	eventCount	workEvent;
+	eventCount	doneEvent;
+//
+//	per stage timing, in nsec
+	std::atomic<int64_t>	fftTime;
+	std::atomic<int64_t>	copyTime;
+	int64_t		demodTime;
+	int64_t		waitTime;
+	int32_t		symbolCount;
+	std::vector<std::complex<float>>	inputBuffer;
+#else
+//
+//	The symbols of a frame are collected in frameBuffer, T_s
+//	samples per symbol, and transformed in two batches, one for
+//	the FIC and one for the MSC blocks, into carrierBuffer
+	std::complex<float>	*frameBuffer;
+	std::complex<float>	*carrierBuffer;
+	fftBatch	*ficBatch;
+	fftBatch	*mscBatch;
+	std::vector<uint8_t>	frameUse;
+	void		enterBlock	(std::complex<float> *, int32_t);
+	void		transformMsc	(void);
 #endif
 	int32_t		T_s;
 	int32_t		T_u;
@@ -91,9 +143,10 @@ private:
 	int32_t		nrBlocks;
 	int32_t		carriers;
 	int16_t		getMiddle	(void);
-	std::vector<complex<float>>	phaseReference;
-	std::vector<int16_t>		ibits;
-	std::complex<float>	*fft_buffer;
+	std::vector<int8_t>		ibits;
+//	carrier i is found in bin binTable [i] of the FFT output
+	std::vector<int32_t>		binTable;
+	demodulator			demodulateBlock;
 	interLeaver	myMapper;
 	phaseTable	*phasetable;
 	int32_t		blockIndex;
@@ -106,4 +159,3 @@ signals:
 
 #endif
 
-
@@ -43,9 +43,15 @@ public:
 #endif
 	                                         int16_t, int16_t);
 			~phaseReference		(void);
-	int32_t		findIndex		(std::vector<std::complex<float>>);
-	int16_t		estimate_CarrierOffset	(std::vector<std::complex<float>>);
-	float		estimate_FrequencyOffset (std::vector<std::complex<float>>);
+//	the functions only read the T_u samples v points to
+	int32_t		findIndex		(std::complex<float> *v);
+	int32_t		trackIndex		(std::complex<float> *v,
+	                                         int32_t expected,
+	                                         int32_t window);
+	int32_t		acquire			(std::complex<float> *v,
+	                                         float *offset);
+	int16_t		estimate_CarrierOffset	(std::complex<float> *v);
+	float		estimate_FrequencyOffset (std::complex<float> *v);
 //
 //	This one is used in the ofdm decoder
 	std::vector<std::complex<float>> refTable;
@@ -56,6 +62,24 @@ private:
 	RingBuffer<float> *response;
 #endif
 	std::vector<float> phaseDifferences;
+//	the carriers where the phase difference with the successor
+//	should be 0, and the scratch for estimate_CarrierOffset
+	std::vector<int16_t>	nullDiffs;
+	std::vector<std::complex<float>> carrierWindow;
+	std::vector<float>	computedDiffs;
+//	for acquire, the spectrum of v and the products of successive
+//	carriers, measured and as they should be
+	std::vector<std::complex<float>> spectrum;
+	std::vector<std::complex<float>> carrierDiffs;
+	std::vector<std::complex<float>> refDiffs;
+	std::vector<float>	peakBuffer;
+	int32_t		peakIndex		(void);
+//	the conjugated time domain version of block 0, for trackIndex
+	std::vector<float>	refTimeRe;
+	std::vector<float>	refTimeIm;
+	float		refEnergy;
+	std::vector<float>	trackRe;
+	std::vector<float>	trackIm;
 	int16_t		threshold;
 	int16_t		diff_length;
 	int32_t		T_u;
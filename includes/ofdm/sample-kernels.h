@@ -0,0 +1,69 @@
+#
+/*
+ *    Copyright (C) 2013 .. 2017
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#
+#ifndef	__SAMPLE_KERNELS__
+#define	__SAMPLE_KERNELS__
+/*
+ *	Block oriented kernels for the sample reader and the
+ *	time synchronization.
+ *	The variant (AVX, SSE2 or plain C++) is chosen at compile time,
+ *	depending on the instruction set the compiler is allowed to use
+ */
+#include	<stdint.h>
+#include	<complex>
+
+#define	LEVEL_ALPHA	0.00001
+
+//
+//	one step of the level tracker, to be used wherever the level
+//	is followed sample by sample
+static inline
+float	nextLevel	(float level, float e) {
+	return LEVEL_ALPHA * e + (1 - LEVEL_ALPHA) * level;
+}
+
+//
+//	v [i] *= osc [i], for 0 <= i < n, while tracking the signal level
+//	as in
+//	level = LEVEL_ALPHA * jan_abs (v [i]) + (1 - LEVEL_ALPHA) * level
+//	The updated level is returned
+float	correctAndLevel	(std::complex<float> *v,
+	                 const std::complex<float> *osc,
+	                 int32_t n, float level);
+//
+//	v [i] *= osc [i], and env [i] = jan_abs (v [i]), for 0 <= i < n
+void	correctAndEnvelope (std::complex<float> *v,
+	                    const std::complex<float> *osc,
+	                    float *env, int32_t n);
+//
+//	sum (x [i] * r [i]), for 0 <= i < n, with x and r given
+//	as separate real and imaginary parts
+std::complex<float>	correlate	(const float *xRe, const float *xIm,
+	                                 const float *rRe, const float *rIm,
+	                                 int32_t n);
+//
+//	sum (a [i] * conj (b [i])), for 0 <= i < n
+std::complex<float>	lagProduct	(const std::complex<float> *a,
+	                                 const std::complex<float> *b,
+	                                 int32_t n);
+#endif
+
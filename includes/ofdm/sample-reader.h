@@ -34,11 +34,19 @@
 #include	<vector>
 #include	"virtual-input.h"
 #include	"ringbuffer.h"
+#include	"sample-kernels.h"
 //
 //      Note:
 //      It was found that enlarging the buffersize to e.g. 8192
 //      cannot be handled properly by the underlying system.
 #define DUMPSIZE                4096
+//
+//	number of single samples after which the oscillator phasor
+//	is recomputed from the (integer) phase
+#define	ANCHOR_PERIOD		1024
+//
+//	max time (msec) to wait for samples before checking "running" again
+#define	WAIT_TIMEOUT		100
 
 class	RadioInterface;
 class	sampleReader : public QObject {
@@ -53,6 +61,9 @@ public:
 		std::complex<float> getSample	(int32_t);
 	        void	getSamples	(std::complex<float> *v,
 	                                 int16_t n, int32_t phase);
+		int32_t	peekEnvelope	(const float **, int32_t, int32_t);
+		void	consume		(int32_t);
+		void	resetBuffer	(void);
 	        void	startDumping	(SNDFILE *);
 	        void	stopDumping	(void);
 	        void	setSpectrum	(bool);
@@ -63,7 +74,20 @@ private:
 		int32_t		localCounter;
 		int32_t		bufferSize;
 		int32_t		currentPhase;
-		std::complex<float>	*oscillatorTable;
+		std::complex<double>	phasor;
+		std::complex<double>	stepPhasor;
+		int32_t		stepOffset;
+		int32_t		anchorCount;
+		void		setStep		(int32_t);
+		void		setAnchor	(void);
+		void		makeOscillator	(std::complex<float> *,
+	                                         int32_t, int32_t);
+		std::vector<std::complex<float>> oscillatorBuffer;
+		std::vector<std::complex<float>> pendingBuffer;
+		std::vector<float>	pendingEnvelope;
+		int32_t		pendingIndex;
+		int32_t		pendingCount;
+		int32_t		fetchSamples	(std::complex<float> *, int32_t);
 		std::atomic<bool>	running;
 		int32_t		bufferContent;
 		float		sLevel;
@@ -0,0 +1,37 @@
+#
+/*
+ *    Copyright (C) 2013 .. 2017
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#
+#ifndef	__CPU_FEATURES__
+#define	__CPU_FEATURES__
+/*
+ *	What the cpu we are running on offers, as found by cpuid.
+ *	Kernels for the extensions beyond the ones the compiler
+ *	may assume are compiled in with a target attribute, and
+ *	are only selected - at startup - when these say so.
+ *	SSE2 is not asked for, its kernels are there when the
+ *	compiler may assume it (__SSE2__).
+ *	On other than x86 cpu's the answer is always false
+ */
+bool	cpu_hasSSSE3	(void);
+bool	cpu_hasAVX2	(void);
+#endif
+
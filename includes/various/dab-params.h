@@ -52,6 +52,22 @@ private:
 	int16_t		carrierDiff;
 	int16_t		CIFs;
 };
+//
+//	The main parameters once more, as compile time constants,
+//	for the kernels that are instantiated per mode
+template <int mode>	struct modeConstants;
+
+template <>	struct modeConstants <1> {
+	enum { L = 76, K = 1536, T_u = 2048, T_s = 2552, T_g = 504 };
+};
+
+template <>	struct modeConstants <2> {
+	enum { L = 76, K = 384, T_u = 512, T_s = 638, T_g = 126 };
+};
+
+template <>	struct modeConstants <4> {
+	enum { L = 76, K = 768, T_u = 1024, T_s = 1276, T_g = 252 };
+};
 
 #endif
 
@@ -0,0 +1,79 @@
+#
+/*
+ *    Copyright (C) 2013 .. 2017
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#
+#ifndef	__EVENT_COUNT__
+#define	__EVENT_COUNT__
+/*
+ *	An eventCount lets a thread sleep until some - lock free -
+ *	condition changes, while the thread changing the condition
+ *	only touches the semaphore when someone is actually sleeping.
+ *	The waiting side does
+ *	   if (!condition) {
+ *	      e. prepareWait ();
+ *	      if (condition)
+ *	         e. cancelWait ();
+ *	      else
+ *	         e. wait (msecs);
+ *	   }
+ *	and the other side makes the condition true and calls notify.
+ *	A spurious wakeup is possible, the condition should be
+ *	tested again after waiting.
+ */
+#include	<QSemaphore>
+#include	<atomic>
+
+class	eventCount {
+public:
+		eventCount	(void): bell (0) {
+	   sleepers. store (0);
+	}
+		~eventCount	(void) {}
+
+	void	prepareWait	(void) {
+	   sleepers. fetch_add (1);
+	}
+
+	void	cancelWait	(void) {
+	   sleepers. fetch_sub (1);
+	}
+
+	void	wait		(int msecs) {
+	   bell. tryAcquire (1, msecs);
+	   sleepers. fetch_sub (1);
+	}
+
+	void	notify		(void) {
+	   if (sleepers. load () > 0)
+	      bell. release (1);
+	}
+
+	void	notifyAll	(void) {
+	   int n = sleepers. load ();
+	   if (n > 0)
+	      bell. release (n);
+	}
+private:
+	QSemaphore	bell;
+	std::atomic<int>	sleepers;
+};
+#endif
+
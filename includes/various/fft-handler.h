@@ -30,22 +30,45 @@
 
 #define FFTW_MALLOC		fftwf_malloc
 #define FFTW_PLAN_DFT_1D	fftwf_plan_dft_1d
+#define	FFTW_PLAN_MANY_DFT	fftwf_plan_many_dft
 #define FFTW_DESTROY_PLAN	fftwf_destroy_plan
 #define FFTW_FREE		fftwf_free
 #define FFTW_PLAN		fftwf_plan
 #define FFTW_EXECUTE		fftwf_execute
+#define	FFTW_EXECUTE_DFT	fftwf_execute_dft
+#define	FFTW_IMPORT_WISDOM	fftwf_import_wisdom_from_filename
+#define	FFTW_EXPORT_WISDOM	fftwf_export_wisdom_to_filename
 #include    <fftw3.h>
 
 /*
  *  a simple wrapper
  */
 
+//
+//	Planning: effort is "estimate" (the default), "measure" or
+//	"patient". With the latter two, the wisdom gathered is kept in
+//	wisdomFile, and imported on later runs, so that - after the
+//	first run - measured plans come (almost) for free.
+//	To be called before any fftHandler is created
+void	setFFTplanning		(const QString &effort,
+	                         const QString &wisdomFile);
+//
+//	create the plans for all DAB modes, as used by the
+//	handlers below, with the given effort, report their
+//	execution times and store the wisdom
+void	generateFFTwisdom	(const QString &effort,
+	                         const QString &wisdomFile);
+
 class   fftHandler {
 public:
 		fftHandler	(uint8_t);
         	~fftHandler	(void);
         std::complex<float>  *getVector (void);
         void		do_FFT (void);
+//	in place on v, which should be allocated with FFTW_MALLOC.
+//	Unlike the other two, this one may be called from
+//	different threads at the same time
+        void		do_FFT (std::complex<float> *v);
         void		do_IFFT (void);
     private:
 	dabParams	p;
@@ -54,6 +77,22 @@ public:
         FFTW_PLAN   plan;
 };
 
+//
+//	A batch of howMany FFTs of size T_u, the input of FFT i
+//	starting at in [i * inDistance], the output going to
+//	out [i * T_u]. Both in and out should be allocated
+//	with FFTW_MALLOC
+class	fftBatch {
+public:
+		fftBatch	(uint8_t mode, int32_t howMany,
+	                         std::complex<float> *in, int32_t inDistance,
+	                         std::complex<float> *out);
+		~fftBatch	(void);
+	void	do_FFT		(void);
+private:
+	FFTW_PLAN	plan;
+};
+
 class   common_ifft {
 public:
 		common_ifft (int32_t);
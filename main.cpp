@@ -26,10 +26,12 @@
 #include        <QSettings>
 #include	<QTranslator>
 #include        <QDir>
+#include	<QFileInfo>
 #include	<QDebug>
 #include        <unistd.h>
 #include        "dab-constants.h"
 #include        "radio.h"
+#include	"fft-handler.h"
 
 #ifdef	HAVE_RTLSDR
 #include	"rtlsdr-handler.h"
@@ -45,6 +47,7 @@
 #endif
 #define DEFAULT_INI     ".dabradio.ini"
 #define	SERVICE_LIST	".dabradio-stations.bin"
+#define	FFTW_WISDOM	".dabradio-fftw.wisdom"
 
 #ifndef	GITHASH
 #define	GITHASH	"      "
@@ -80,6 +83,8 @@ RadioInterface  *MyRadioInterface;
 virtualInput	*theDevice;
 // Default values
 QSettings       *dabSettings;           // ini file
+QString	wisdomEffort	= "";
+QString	wisdomFile;
 int     opt;
 
 	QCoreApplication::setOrganizationName ("Lazy Chair Computing");
@@ -87,7 +92,7 @@ int     opt;
 	QCoreApplication::setApplicationName ("dabradio");
 	QCoreApplication::setApplicationVersion (QString (CURRENT_VERSION) + " Git: " + GITHASH);
 
-	while ((opt = getopt (argc, argv, "i:c:")) != -1) {
+	while ((opt = getopt (argc, argv, "i:c:W:")) != -1) {
 	   switch (opt) {
 	      case 'i':
 	         initFileName	= fullPathfor (QString (optarg), ".ini");
@@ -99,11 +104,27 @@ int     opt;
 	      case 'c':
 	         serviceList	= fullPathfor (QString (optarg), ".bin");
 	         break;
+
+	      case 'W':		// -W measure or -W patient
+	         wisdomEffort	= QString (optarg);
+	         break;
 	   }
 	}
 
+//	the fftw wisdom is kept next to the ini file.
+//	With -W, we just generate it for all modes and stop
+	wisdomFile	= QFileInfo (initFileName). absolutePath () +
+	                                      "/" + FFTW_WISDOM;
+	if (wisdomEffort != "") {
+	   generateFFTwisdom (wisdomEffort, wisdomFile);
+	   exit (0);
+	}
 	
 	dabSettings =  new QSettings (initFileName, QSettings::IniFormat);
+//	"estimate", "measure" or "patient"
+	setFFTplanning (dabSettings -> value ("fftwPlanning",
+	                                      "estimate"). toString (),
+	                wisdomFile);
 /*
  *      Before we connect control to the gui, we have to
  *      instantiate
@@ -76,6 +76,26 @@ int	gain;
 	           dabSettings -> value ("latency", 5). toInt ();
 	diff_length	=
 	           dabSettings	-> value ("diff_length", DIFF_LENGTH). toInt ();
+//
+//	once in sync, the start of a frame is only looked for
+//	within trackWindow samples from where it is expected.
+//	After trackMisses frames in a row with no clear correlation
+//	peak there, the full search is done again.
+//	trackWindow = 0 means always the full search
+	trackWindow	=
+	           dabSettings	-> value ("trackWindow", 4). toInt ();
+	trackMisses	=
+	           dabSettings	-> value ("trackMisses", 2). toInt ();
+//
+//	with acquisition set, time and frequency offset are found
+//	from a single block 0, rather than over a number of frames
+	acquisition	=
+	           dabSettings	-> value ("acquisition", 1). toInt () != 0;
+//
+//	with ficDutyCycle > 1, once the ensemble is stable, only
+//	one out of ficDutyCycle frames has its FIC decoded
+	ficDutyCycle	=
+	           dabSettings	-> value ("ficDutyCycle", 1). toInt ();
 
         dabMode		= dabSettings   -> value ("dabMode", 1). toInt ();
 	if ((dabMode != 1) && (dabMode != 2))
@@ -168,6 +188,8 @@ int	gain;
 	                                    inputDevice,
 	                                    dabMode,
 	                                    threshold, diff_length,
+	                                    trackWindow, trackMisses,
+	                                    acquisition, ficDutyCycle,
                                             picturesPath);
 	connect (my_dabProcessor, SIGNAL (setSynced (char)),
                  this, SLOT (setSynced (char)));
@@ -190,15 +212,18 @@ int	gain;
 	fprintf (stderr, "radioInterface is deleted\n");
 }
 //
-//	A little tricky, there are two signals that may trigger nextChannel
+//	A little tricky, there are three signals that may trigger nextChannel
 //	The "no dab is here" signal, which should arrive within
 //	a second or so after starting the decoding,
+//	the "ensemble is complete" signal from the probe,
 //	or a timeout
 void	RadioInterface:: startScanning (void) {
 	disconnect (&signalTimer, SIGNAL (timeout (void)),
 	            this, SLOT (nextChannel (void)));
 	disconnect (my_dabProcessor, SIGNAL (No_Signal_Found (void)),
                     this, SLOT (nextChannel (void)));
+	disconnect (my_dabProcessor, SIGNAL (ensembleComplete (void)),
+	            this, SLOT (nextChannel (void)));
 	disconnect (ensembleDisplay,
 	            SIGNAL (newService (const QString &, const QString &)),
 	            this, SLOT (selectService (const QString &, const QString &)));
@@ -222,6 +247,8 @@ void	RadioInterface:: startScanning (void) {
 	               this, SLOT (nextChannel (void)));
            disconnect (my_dabProcessor, SIGNAL (No_Signal_Found (void)),
                        this, SLOT (nextChannel (void)));
+	   disconnect (my_dabProcessor, SIGNAL (ensembleComplete (void)),
+	               this, SLOT (nextChannel (void)));
 	   connect (ensembleDisplay,
 	            SIGNAL (newService (const QString &, const QString &)),
 	            this, SLOT (selectService (const QString &, const QString &)));
@@ -244,7 +271,9 @@ void	RadioInterface:: startScanning (void) {
 	         this, SLOT (nextChannel (void)));
 	connect (my_dabProcessor, SIGNAL (No_Signal_Found (void)),
 	         this, SLOT (nextChannel (void)));
-	my_dabProcessor -> start (tunedFrequency, true);
+	connect (my_dabProcessor, SIGNAL (ensembleComplete (void)),
+	         this, SLOT (nextChannel (void)));
+	my_dabProcessor -> startProbe (tunedFrequency);
 	running. store (true);
 	signalTimer. start (5000);
 	scanning	= true;
@@ -257,6 +286,8 @@ void	RadioInterface::nextChannel (void) {
 	            this, SLOT (nextChannel (void)));
 	disconnect (my_dabProcessor, SIGNAL (No_Signal_Found (void)),
                     this, SLOT (nextChannel (void)));
+	disconnect (my_dabProcessor, SIGNAL (ensembleComplete (void)),
+	            this, SLOT (nextChannel (void)));
 	signalTimer. stop ();
 	my_dabProcessor -> stop ();
 	channelNumber++;
@@ -291,7 +322,9 @@ void	RadioInterface::nextChannel (void) {
 	         this, SLOT (nextChannel (void)));
 	connect (my_dabProcessor, SIGNAL (No_Signal_Found (void)),
 	         this, SLOT (nextChannel (void)));
-	my_dabProcessor	-> start (tunedFrequency, true);
+	connect (my_dabProcessor, SIGNAL (ensembleComplete (void)),
+	         this, SLOT (nextChannel (void)));
+	my_dabProcessor	-> startProbe (tunedFrequency);
 	signalTimer. start (5000);
 }
 
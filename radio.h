@@ -125,6 +125,10 @@ private:
 	uint8_t		isSynced;
 	int16_t		threshold;
 	int16_t		diff_length;
+	int16_t		trackWindow;
+	int16_t		trackMisses;
+	bool		acquisition;
+	int16_t		ficDutyCycle;
 	bandHandler	*theBand;
 	int		channels;
 	std::atomic<bool>	running;
@@ -26,10 +26,10 @@
 #include	"mp4processor.h"
 #include	"eep-protection.h"
 #include	"uep-protection.h"
+#include	"time-deinterleaver.h"
 #include	"radio.h"
 //
-//	Interleaving is - for reasons of simplicity - done
-//	inline rather than through a special class-object
+//	The time de-interleaving is shared with the data backend
 //
 //	fragmentsize == Length * CUSize
 	audioBackend::audioBackend	(RadioInterface *mr,
@@ -38,7 +38,7 @@
 	                                 QString	picturesPath):
 	                                    virtualBackend (d -> startAddr,
 	                                                    d -> length),
-	                                    outV (d -> bitRate * 24)
+	                                    outV (d -> bitRate * 24 / 8)
 #ifdef	__THREADED_BACKEND
 	                             ,freeSlots (20) 
 #endif 
@@ -53,14 +53,7 @@ int32_t i, j;
 
 	this	-> audioBuffer		= buffer;
 
-	interleaveData		= new int16_t *[16]; // max size
-	for (i = 0; i < 16; i ++) {
-	   interleaveData [i] = new int16_t [fragmentSize];
-	   memset (interleaveData [i], 0, fragmentSize * sizeof (int16_t));
-	}
-
-	countforInterleaver	= 0;
-	interleaverIndex	= 0;
+	deinterleaver		= new timeDeinterleaver (fragmentSize);
 
 	if (shortForm)
 	   protectionHandler	= new uep_protection (bitRate,
@@ -86,22 +79,25 @@ int32_t i, j;
 	fprintf (stderr, "we now have %s\n", dabModus == DAB_PLUS ? "DAB+" : "DAB");
 	tempX. resize (fragmentSize);
 	
+//	the energy dispersal vector is packed, as the output of
+//	the deconvolution is
 	uint8_t shiftRegister [9];
-	disperseVector. resize (24 * bitRate);
+	disperseVector. resize (24 * bitRate / 8);
 	memset (shiftRegister, 1, 9);
+	memset (disperseVector. data (), 0, 24 * bitRate / 8);
 	for (i = 0; i < bitRate * 24; i ++) {
 	   uint8_t b = shiftRegister [8] ^ shiftRegister [4];
 	   for (j = 8; j > 0; j--)
 	      shiftRegister [j] = shiftRegister [j - 1];
 	   shiftRegister [0] = b;
-	   disperseVector [i] = b;
+	   disperseVector [i >> 3] |= b << (7 - (i & 07));
 	}
 #ifdef	__THREADED_BACKEND
 //	for local buffering the input, we have
 	nextIn				= 0;
 	nextOut				= 0;
 	for (i = 0; i < 20; i ++)
-	   theData [i] = new int16_t [fragmentSize];
+	   theData [i] = new int8_t [fragmentSize];
 	running. store (true);
 	start ();
 #endif
@@ -116,22 +112,20 @@ int16_t	i;
 #endif
 	delete protectionHandler;
 	delete our_dabProcessor;
-	for (i = 0; i < 16; i ++) 
-	   delete[]  interleaveData [i];
-	delete [] interleaveData;
+	delete deinterleaver;
 #ifdef	__THREADED_BACKEND
 	for (i = 0; i < 20; i ++)
 	   delete [] theData [i];
 #endif
 }
 
-int32_t	audioBackend::process	(int16_t *v, int16_t cnt) {
+int32_t	audioBackend::process	(int8_t *v, int16_t cnt) {
 
 #ifdef	__THREADED_BACKEND
 	while (!freeSlots. tryAcquire (1, 200))
 	   if (!running)
 	      return 0;
-	memcpy (theData [nextIn], v, fragmentSize * sizeof (int16_t));
+	memcpy (theData [nextIn], v, fragmentSize * sizeof (int8_t));
 	nextIn = (nextIn + 1) % 20;
 	usedSlots. release ();
 #else
@@ -141,37 +135,28 @@ int32_t	audioBackend::process	(int16_t *v, int16_t cnt) {
 }
 
 
-const	int16_t interleaveMap [] = {0,8,4,12,2,10,6,14,1,9,5,13,3,11,7,15};
-void	audioBackend::processSegment (int16_t *Data) {
-int16_t	i, j;
-
-	for (i = 0; i < fragmentSize; i ++) {
-	   tempX [i] = interleaveData [(interleaverIndex + 
-	                                interleaveMap [i & 017]) & 017][i];
-	   interleaveData [interleaverIndex][i] = Data [i];
-	}
+void	audioBackend::processSegment (int8_t *Data) {
+int16_t	i;
+bool	filled	= deinterleaver -> process (Data, tempX. data ());
 
-	interleaverIndex = (interleaverIndex + 1) & 0x0F;
 #ifdef	__THREADED_BACKEND
 	nextOut = (nextOut + 1) % 20;
 	freeSlots. release ();
 #endif
 
 //	only continue when de-interleaver is filled
-	if (countforInterleaver <= 15) {
-	   countforInterleaver ++;
+	if (!filled)
 	   return;
-	}
 
 	protectionHandler -> deconvolve (tempX. data (),
 	                                 fragmentSize,
 	                                 outV. data ());
 //
 //	and the energy dispersal
-	for (i = 0; i < bitRate * 24; i ++)
+	for (i = 0; i < bitRate * 24 / 8; i ++)
 	   outV [i] ^= disperseVector [i];
 
-	our_dabProcessor -> addtoFrame (outV);
+	our_dabProcessor -> addtoFrame (outV. data ());
 }
 
 #ifdef	__THREADED_BACKEND
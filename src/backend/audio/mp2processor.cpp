@@ -578,30 +578,64 @@ int32_t table_idx;
 }
 
 //
-//	bits to MP2 frames, amount is amount of bits
-void	mp2Processor::addtoFrame (std::vector<uint8_t> v) {
-int16_t	i, j;
+//	copy n bits, starting at bit "from" of in, to out, starting at
+//	bit "to". Once "to" is at a byte boundary, the bits go byte
+//	by byte, for a DAB frame both are at a byte boundary
+static
+void	copyBits	(uint8_t *out, int32_t to,
+	                 const uint8_t *in, int32_t from, int32_t n) {
+int16_t	shift;
+
+	while ((n > 0) && ((to & 07) != 0)) {
+	   uint8_t mask	= 0200 >> (to & 07);
+	   if ((in [from >> 3] << (from & 07)) & 0200)
+	      out [to >> 3] |= mask;
+	   else
+	      out [to >> 3] &= ~mask;
+	   to ++; from ++; n --;
+	}
+	shift	= from & 07;
+	if (shift == 0)
+	   memcpy (&out [to >> 3], &in [from >> 3], n >> 3);
+	else
+	   for (int32_t k = 0; k < (n >> 3); k ++)
+	      out [(to >> 3) + k] =
+	                (in [(from >> 3) + k] << shift) |
+	                (in [(from >> 3) + k + 1] >> (8 - shift));
+	to	+= n & ~07;
+	from	+= n & ~07;
+	n	&= 07;
+	if (n > 0) {	// the remaining bits, the others are don't care
+	   uint16_t w	= (in [from >> 3] << 8) |
+	                  (((from & 07) + n > 8) ? in [(from >> 3) + 1] : 0);
+	   out [to >> 3]	= (w << (from & 07)) >> 8;
+	}
+}
+//
+//	bits to MP2 frames, amount is amount of bits, the input is
+//	packed. Only finding the sync and the header - the first
+//	24 bits of a frame - is done bit by bit
+void	mp2Processor::addtoFrame (uint8_t *v) {
+int16_t	j;
+int32_t	i;
 int16_t	lf	= baudRate == 48000 ? MP2framesize : 2 * MP2framesize;
 int16_t	amount	= MP2framesize;
-uint8_t	help [24 * bitRate / 8];
 int16_t	vLength	= 24 * bitRate / 8;
 
-	for (i = 0; i < 24 * bitRate / 8; i ++) {
-	   help [i] = 0;
-	   for (j = 0; j < 8; j ++) {
-	      help [i] <<= 1;
-	      help [i] |= v [8 * i + j] & 01;
-	   }
-	}
-	{ uint8_t L0	= help [vLength - 1];
-	  uint8_t L1	= help [vLength - 2];
+	{ uint8_t L0	= v [vLength - 1];
+	  uint8_t L1	= v [vLength - 2];
 	  int16_t down	= bitRate * 1000 >= 56000 ? 4 : 2;
-	  my_padhandler. processPAD (help, vLength - 2 - down - 1, L1, L0);
+	  my_padhandler. processPAD (v, vLength - 2 - down - 1, L1, L0);
 	}
 
-	for (i = 0; i < amount; i ++) {
+	i = 0;
+	while (i < amount) {
 	   if (MP2Header_OK == 2) {
-	      addbittoMP2 (MP2frame, v [i], MP2bitCount ++);
+	      int32_t n	= lf - MP2bitCount < amount - i ?
+	                               lf - MP2bitCount : amount - i;
+	      copyBits (MP2frame, MP2bitCount, v, i, n);
+	      MP2bitCount	+= n;
+	      i			+= n;
 	      if (MP2bitCount >= lf) {
 	         int16_t sample_buf [KJMP2_SAMPLES_PER_FRAME * 2];
 	         if (mp2decodeFrame (MP2frame, sample_buf)) {
@@ -616,10 +650,13 @@ int16_t	vLength	= 24 * bitRate / 8;
 	         MP2headerCount = 0;
 	         MP2bitCount = 0;
 	      }
-	   } else 
+	      continue;
+	   }
+	   uint8_t bit	= (v [i >> 3] >> (7 - (i & 07))) & 01;
+	   i ++;
 	   if (MP2Header_OK == 0) {
 //	apparently , we are not in sync yet
-	      if (v [i] == 01) {
+	      if (bit == 01) {
 	         if (++ MP2headerCount == 12) {
 	            MP2bitCount = 0;
 	            for (j = 0; j < 12; j ++)
@@ -632,7 +669,7 @@ int16_t	vLength	= 24 * bitRate / 8;
 	   }
 	   else
 	   if (MP2Header_OK == 1) {
-	      addbittoMP2 (MP2frame, v [i], MP2bitCount ++);
+	      addbittoMP2 (MP2frame, bit, MP2bitCount ++);
 	      if (MP2bitCount == 24) {
 	         setSamplerate (mp2sampleRate (MP2frame));
 	         MP2Header_OK = 2;
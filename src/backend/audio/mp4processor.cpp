@@ -60,7 +60,7 @@
 	superFramesize		= 110 * (bitRate / 8);
 	RSDims			= bitRate / 8;
 	frameBytes		= new uint8_t [RSDims * 120];	// input
-	outVector		= new uint8_t [RSDims * 110];
+	outVector		= new uint8_t [RSDims * 120];
 	blockFillIndex	= 0;
 	blocksInBuffer	= 0;
 	frameCount	= 0;
@@ -82,21 +82,13 @@
   *	a DAB+ superframe consists of 5 consecutive DAB frames 
   *	we add vector for vector to the superframe. Once we have
   *	5 lengths of "old" frames, we check
-  *	Note that the packing in the entry vector is still one bit
-  *	per Byte, nbits is the number of Bits (i.e. containing bytes)
-  *	the function adds nbits bits, packed in bytes, to the frame
+  *	The entry vector is packed already, nbits is the number of
+  *	bits, i.e. nbits / 8 bytes are added to the frame
   */
-void	mp4Processor::addtoFrame (std::vector<uint8_t> V) {
-int16_t	i, j;
-uint8_t	temp	= 0;
+void	mp4Processor::addtoFrame (uint8_t *V) {
 int16_t	nbits	= 24 * bitRate;
 
-	for (i = 0; i < nbits / 8; i ++) {	// in bytes
-	   temp = 0;
-	   for (j = 0; j < 8; j ++)
-	      temp = (temp << 1) | (V [i * 8 + j] & 01);
-	   frameBytes [blockFillIndex * nbits / 8 + i] = temp;
-	}
+	memcpy (&frameBytes [blockFillIndex * nbits / 8], V, nbits / 8);
 //
 	blocksInBuffer ++;
 	blockFillIndex = (blockFillIndex + 1) % 5;
@@ -147,9 +139,8 @@ int16_t	nbits	= 24 * bitRate;
   */
 bool	mp4Processor::processSuperframe (uint8_t frameBytes [], int16_t base) {
 uint8_t		num_aus;
-int16_t		i, j, k;
-uint8_t		rsIn	[120];
-uint8_t		rsOut	[110];
+int16_t		i;
+int32_t		size	= RSDims * 120;
 uint8_t		dacRate;
 uint8_t		sbrFlag;
 uint8_t		aacChannelMode;
@@ -162,18 +153,16 @@ int32_t		tmp;
   *	OK, what we now have is a vector with RSDims * 120 uint8_t's
   *	the superframe, containing parity bytes for error repair
   *	take into account the interleaving that is applied.
+  *	The superframe starts at base in the - circular - frameBytes,
+  *	once it is straightened out, byte k of codeword j is at
+  *	j + k * RSDims, that is the layout the batch decoder wants.
+  *	The corrected data then is in the first RSDims * 110 bytes
   */
-	for (j = 0; j < RSDims; j ++) {
-	   int16_t ler	= 0;
-	   for (k = 0; k < 120; k ++) 
-	      rsIn [k] = frameBytes [(base + j + k * RSDims) % (RSDims * 120)];
-	   ler = my_rsDecoder. dec (rsIn, rsOut, 135);
-	   if (ler < 0) {
-	      rsErrors ++;
-	      return false;
-	   }
-	   for (k = 0; k < 110; k ++) 
-	      outVector [j + k * RSDims] = rsOut [k];
+	memcpy (outVector, &frameBytes [base], size - base);
+	memcpy (&outVector [size - base], frameBytes, base);
+	if (my_rsDecoder. decBatch (outVector, RSDims, 135) < 0) {
+	   rsErrors ++;
+	   return false;
 	}
 
 //	bits 0 .. 15 is firecode
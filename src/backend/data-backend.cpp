@@ -27,12 +27,9 @@
 #include	"eep-protection.h"
 #include	"uep-protection.h"
 #include	"data-processor.h"
+#include	"time-deinterleaver.h"
 
-//	Interleaving is - for reasons of simplicity - done
-//	inline rather than through a special class-object
-//	We could make a single handler for interleaving
-//	and deconvolution, but it is a pretty simple operation
-//	so for now keep it in-line
+//	The time de-interleaving is shared with the audio backend
 //
 //	The main function of this class is to assemble the 
 //	MSCdatagroups and dispatch to the appropriate handler
@@ -58,15 +55,10 @@ int32_t i, j;
 	nextIn                          = 0;
         nextOut                         = 0;
         for (i = 0; i < 20; i ++)
-           theData [i] = new int16_t [fragmentSize];
+           theData [i] = new int8_t [fragmentSize];
 
-	outV			= new uint8_t [24 * bitRate];
-	interleaveData		= new int16_t *[16]; // the size
-	for (i = 0; i < 16; i ++) {
-	   interleaveData [i] = new int16_t [fragmentSize];
-	   memset (interleaveData [i], 0, fragmentSize * sizeof (int16_t));
-	}
-	countforInterleaver	= 0;
+	outV			= new uint8_t [24 * bitRate / 8];
+	deinterleaver		= new timeDeinterleaver (fragmentSize);
 //
 //	The handling of the depuncturing and deconvolution is
 //	shared with that of the audio
@@ -78,15 +70,16 @@ int32_t i, j;
 	                                              d -> protLevel);
 //
 	uint8_t shiftRegister [9];
-	disperseVector. resize (24 * bitRate);
-//	and the energy dispersal
+	disperseVector. resize (24 * bitRate / 8);
+//	and the energy dispersal, packed as the output of the deconvolution
 	memset (shiftRegister, 1, 9);
+	memset (disperseVector. data (), 0, 24 * bitRate / 8);
 	for (i = 0; i < bitRate * 24; i ++) {
 	   uint8_t b = shiftRegister [8] ^ shiftRegister [4];
 	   for (j = 8; j > 0; j--)
 	      shiftRegister [j] = shiftRegister [j - 1];
 	   shiftRegister [0] = b;
-	   disperseVector[i] = b;
+	   disperseVector [i >> 3] |= b << (7 - (i & 07));
 	}
 
 	start ();
@@ -98,32 +91,27 @@ int16_t	i;
 	while (this -> isRunning ())
 	   usleep (1);
 	delete protectionHandler;
-	for (i = 0; i < 16; i ++)
-	   delete[] interleaveData [i];
         for (i = 0; i < 20; i ++)
            delete [] theData [i];
-	delete[]	interleaveData;
-	delete		outV;
+	delete		deinterleaver;
+	delete[]	outV;
 }
 
-int32_t	dataBackend::process	(int16_t *v, int16_t cnt) {
+int32_t	dataBackend::process	(int8_t *v, int16_t cnt) {
 	(void)cnt;
 	while (!freeSlots. tryAcquire (1, 200))
            if (!running)
               return 0;
-        memcpy (theData [nextIn], v, fragmentSize * sizeof (int16_t));
+        memcpy (theData [nextIn], v, fragmentSize * sizeof (int8_t));
         nextIn = (nextIn + 1) % 20;
         usedSlots. release ();
         return 1;
 }
 
-const   int16_t interleaveMap[] = {0,8,4,12,2,10,6,14,1,9,5,13,3,11,7,15};
-
 void	dataBackend::run	(void) {
-int16_t	countforInterleaver	= 0;
-int16_t interleaverIndex	= 0;
-int16_t	tempX [fragmentSize];
-int16_t	i, j;
+int8_t	tempX [fragmentSize];
+int16_t	i;
+bool	filled;
 
 	running	= true;
 	while (running) {
@@ -133,28 +121,20 @@ int16_t	i, j;
 
 //	   memcpy (Data, theData [nextOut], fragmentSize * sizeof (int16_t));
 
-	   for (i = 0; i < fragmentSize; i ++) {
-	      tempX [i] = interleaveData [(interleaverIndex + 
-	                                 interleaveMap [i & 017]) & 017][i];
-	      interleaveData [interleaverIndex][i] = theData [nextOut] [i];
-	   }
+	   filled = deinterleaver -> process (theData [nextOut], tempX);
            nextOut = (nextOut + 1) % 20;
 	   freeSlots. release ();
 
-	   interleaverIndex = (interleaverIndex + 1) & 0x0F;
-
 //	only continue when de-interleaver is filled
-	   if (countforInterleaver <= 15) {
-	      countforInterleaver ++;
+	   if (!filled)
 	      continue;
-	   }
 //
 	   protectionHandler -> deconvolve (tempX, fragmentSize, outV);
 
-	   for (i = 0; i < bitRate * 24; i ++)
+	   for (i = 0; i < bitRate * 24 / 8; i ++)
 	      outV [i] ^= disperseVector [i];
-//	What we get here is a long sequence (24 * bitrate) of bits, not packed
-//	but forming a DAB packet
+//	What we get here is a long sequence (24 * bitrate) of bits, packed
+//	in bytes, forming a DAB packet
 //	we hand it over to make an MSC data group
 	   our_frameProcessor -> addtoFrame (outV);
 	}
@@ -55,6 +55,7 @@
 	}
 
 	packetState	= 0;
+	bits. resize (24 * bitRate);
 }
 
 	dataProcessor::~dataProcessor	(void) {
@@ -62,14 +63,21 @@
 }
 
 
+//
+//	the packets and datagroups are handled as bits, one bit per byte,
+//	so the packed input is unpacked first
 void	dataProcessor::addtoFrame (uint8_t *outV) {
+int32_t	i;
+
+	for (i = 0; i < 24 * bitRate; i ++)
+	   bits [i] = (outV [i >> 3] >> (7 - (i & 07))) & 01;
 //	There is - obviously - some exception, that is
 //	when the DG flag is on and there are no datagroups for DSCTy5
 	   if ((this -> DSCTy == 5) &&
 	       (this -> DGflag))	// no datagroups
-	      handleTDCAsyncstream (outV, 24 * bitRate);
+	      handleTDCAsyncstream (bits. data (), 24 * bitRate);
 	   else
-	      handlePackets (outV, 24 * bitRate);
+	      handlePackets (bits. data (), 24 * bitRate);
 }
 //
 //	While for a full mix data and audio there will be a single packet in a
@@ -34,8 +34,6 @@
 	eep_protection::eep_protection (int16_t bitRate,
 	                                int16_t protLevel):
 	                                     protection (bitRate, protLevel) {
-int16_t	i, j;
-int16_t	viterbiCounter	= 0;
 int16_t	L1, L2;
 int8_t	*PI1, *PI2, *PI_X;
 
@@ -110,56 +108,28 @@ int8_t	*PI1, *PI2, *PI_X;
 	   }
 	}
 	PI_X	= get_PCodes (8 - 1);
-
-	memset (indexTable. data (), 0,
-	                 (outSize * 4 + 24) * sizeof (uint8_t)); 
 //
 //	according to the standard we process the logical frame
 //	with a pair of tuples
-//	(L1, PI1), (L2, PI2)
+//	(L1, PI1), (L2, PI2), each L a number of 128 bit blocks
 //
-	for (i = 0; i < L1; i ++) {
-	   for (j = 0; j < 128; j ++) {
-	      if (PI1 [j % 32] != 0) 
-	         indexTable [viterbiCounter] = true;
-	      viterbiCounter ++;	
-	   }
-	}
-
-	for (i = 0; i < L2; i ++) {
-	   for (j = 0; j < 128; j ++) {
-	      if (PI2 [j % 32] != 0) 
-	         indexTable [viterbiCounter] = true;
-	      viterbiCounter ++;	
-	   }
-	}
+	addRun (&punctures, L1 * 128, PI1);
+	addRun (&punctures, L2 * 128, PI2);
 //	we had a final block of 24 bits  with puncturing according to PI_X
 //	This block constitues the 6 * 4 bits of the register itself.
-	for (i = 0; i < 24; i ++) {
-	   if (PI_X [i] != 0) 
-	      indexTable [viterbiCounter] = true;
-	   viterbiCounter ++;
-	}
+	addRun (&punctures, 24, PI_X);
 }
 
 	eep_protection::~eep_protection (void) {
 }
 
-bool	eep_protection::deconvolve (int16_t *v,
+//
+//	the viterbi decoder depunctures while reading v
+bool	eep_protection::deconvolve (int8_t *v,
 	                            int32_t size,
 	                            uint8_t *outBuffer) {
-
-int16_t	i;
-int16_t	inputCounter	= 0;
 	(void)size;			// size was known already
-
-	memset (viterbiBlock. data (), 0,
-	                 (outSize * 4 + 24) * sizeof (int16_t)); 
-	for (i = 0; i < outSize * 4 + 24; i ++) 
-	   if (indexTable [i])
-	      viterbiBlock [i] = v [inputCounter ++];
-	
-	viterbi_768::deconvolve (viterbiBlock. data (), outBuffer);
+	viterbi_768::deconvolvePacked (v, &punctures, outBuffer);
 	return true;
 }
 
@@ -29,6 +29,8 @@
 #include	"radio.h"
 #include	"charsets.h"
 //
+//	frames (of 96 msec) without news before an ensemble is complete
+#define	PROBE_QUIET	10
 //
 // Tabelle ETSI EN 300 401 Page 50
 // Table is copied from the work of Michael Hoehn
@@ -113,6 +115,7 @@
 	         myRadioInterface, SLOT (changeinConfiguration (void)));
 
 	CIFcount	= 0;
+	changeAnnounced	= false;
 }
 	
 	fib_processor::~fib_processor (void) {
@@ -311,6 +314,7 @@ uint8_t	CN	= getBits_1 (d, 8 + 0);
 	CIFcount = highpart * 250 + lowpart;
 	if (changeFlag == 0)
 	   return;
+	changeAnnounced	= true;
 
 //	if (changeFlag == 1) {
 //	   fprintf (stderr, "Changes in sub channel organization\n");
@@ -1215,8 +1219,59 @@ int16_t i;
 	ensemble_Descriptor. name_Present = false;
 	ensemble_Descriptor. ecc_Present  = false;
 	isSynced	= false;
+	ensembleItems	= 0;
+	quietFrames	= 0;
+	ensembleReported	= false;
 	fibLocker. unlock ();
 }
+//
+//	checkEnsemble is called once per decoded FIC frame.
+//	The ensemble is taken to be complete when it has a name,
+//	each service has a label and is bound to a component, and
+//	no service, component or subchannel was added for PROBE_QUIET
+//	frames. The MCI (FIG 0/1, 0/2) is repeated about 10 times a
+//	second, so a service we did not see yet would have shown up.
+//	ensembleComplete is signalled once, a service that never gets
+//	a component (e.g. stream data) leaves it to the caller's timeout
+void	fib_processor::checkEnsemble (void) {
+int16_t	i;
+int16_t	items		= 0;
+bool	complete	= isSynced;
+bool	hasComponent [64];
+
+	if (ensembleReported)
+	   return;
+
+	memset (hasComponent, 0, sizeof (hasComponent));
+	fibLocker. lock ();
+	for (i = 0; i < 64; i ++) {
+	   if (subChannels [i]. inUse)
+	      items ++;
+	   if (ServiceComps [i]. inUse) {
+	      items ++;
+	      hasComponent [ServiceComps [i]. service - listofServices] = true;
+	   }
+	}
+	for (i = 0; i < 64; i ++) {
+	   if (!listofServices [i]. inUse)
+	      continue;
+	   items ++;
+	   if (!listofServices [i]. serviceLabel. hasName || !hasComponent [i])
+	      complete = false;
+	}
+	fibLocker. unlock ();
+
+	if (items != ensembleItems) {
+	   ensembleItems	= items;
+	   quietFrames		= 0;
+	   return;
+	}
+
+	if (!complete || (items == 0) || (++quietFrames < PROBE_QUIET))
+	   return;
+	ensembleReported	= true;
+	ensembleComplete ();
+}
 
 //////////////////////////////////////////////////////////////////////
 //	The external world wants from time to time to select
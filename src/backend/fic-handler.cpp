@@ -23,6 +23,9 @@
 #include	"fic-handler.h"
 #include	"radio.h"
 #include	"protTables.h"
+#ifdef	__DECODER_TIMINGS
+#include	<chrono>
+#endif
 //
 //	The 3072 bits of the serial motherword shall be split into
 //	24 blocks of 128 bits each.
@@ -47,8 +50,7 @@
 	                                    params (dabMode),
 	                                    fib_processor (mr),
 	                                    myViterbi (768, true) {
-int16_t	i, j, k;
-int	local	= 0;
+int16_t	i, j;
 
 	index		= 0;
 	BitsperBlock	= 2 * params. get_carriers ();
@@ -56,6 +58,16 @@ int	local	= 0;
 	ficBlocks	= 0;
 	ficMissed	= 0;
 	ficRatio	= 0;
+	dutyCycle	= 1;
+	frameCount	= 0;
+	steady. store (false);
+	goodFrames. store (0);
+	frameCorrect	= true;
+#ifdef	__DECODER_TIMINGS
+	decodedFrames	= 0;
+	skippedFrames	= 0;
+	decodeTime	= 0;
+#endif
 
 	memset (shiftRegister, 1, 9);
 
@@ -67,41 +79,23 @@ int	local	= 0;
 	   shiftRegister [0] = PRBS [i];
 	}
 //
-//	Since the depuncturing is the same throughout all calls
-//	(even through all instances, so we could create a static
-//	table), we make an punctureTable that contains the indices of
-//	the ofdmInput table
-	memset (punctureTable, 0, (3072 + 24) * sizeof (uint8_t));
-	for (i = 0; i < 21; i ++) {
-	   for (k = 0; k < 32 * 4; k ++) {
-	      if (get_PCodes (16 - 1) [k % 32] != 0)  
-	         punctureTable [local] = true;
-	      local ++;
-	   }
-	}
+//	The depuncturing is the same throughout all calls, it is
+//	described by three runs, the viterbi decoder applies it
+//	while reading the ofdm input
+	punctures. nrRuns	= 0;
+	addRun (&punctures, 21 * 128, get_PCodes (16 - 1));
 /**
   *	In the second step
   *	we have 3 blocks with puncturing according to PI_15
   *	each 128 bit block contains 4 subblocks of 32 bits
   *	on which the given puncturing is applied
   */
-	for (i = 0; i < 3; i ++) {
-	   for (k = 0; k < 32 * 4; k ++) {
-	      if (get_PCodes (15 - 1) [k % 32] != 0)  
-	         punctureTable [local] = true;
-	      local ++;
-	   }
-	}
-
+	addRun (&punctures, 3 * 128, get_PCodes (15 - 1));
 /**
   *	we have a final block of 24 bits  with puncturing according to PI_X
   *	This block constitues the 6 * 4 bits of the register itself.
   */
-	for (k = 0; k < 24; k ++) {
-	   if (get_PCodes (8 - 1) [k] != 0) 
-	      punctureTable [local] = true;
-	   local ++;
-	}
+	addRun (&punctures, 24, get_PCodes (8 - 1));
 
 	connect (this, SIGNAL (show_ficSuccess (bool)),
 	         mr, SLOT (show_ficSuccess (bool)));
@@ -123,9 +117,11 @@ int	local	= 0;
   *	Note that Mode III is NOT supported
   *	
   *	The function is called with a blkno. This should be 1, 2 or 3
-  *	for each time 2304 bits are in, we call process_ficInput
+  *	each 2304 bits form a codeword, at block 3 they are decoded
+  *	With data NULL the block was not decoded (see frameNeeded),
+  *	only the frame is counted
   */
-void	ficHandler::process_ficBlock (std::vector<int16_t> data,
+void	ficHandler::process_ficBlock (int8_t *data,
 	                              int16_t blkno) {
 int32_t	i;
 
@@ -135,11 +131,24 @@ int32_t	i;
 	   fib_processor::newFrame ();
 	}
 //
+	if (data == NULL) {
+#ifdef	__DECODER_TIMINGS
+	   if (blkno == 3)
+	      skippedFrames ++;
+#endif
+	   return;
+	}
+#ifdef	__DECODER_TIMINGS
+	auto t0	= std::chrono::steady_clock::now ();
+#endif
+	if (blkno == 1)
+	   frameCorrect	= true;
 	if ((1 <= blkno) && (blkno <= 3)) {
 	   for (i = 0; i < BitsperBlock; i ++) {
-	      ofdm_input [index ++] = data [i];
+	      if (ficno >= 4)	// cannot happen with Modes I, II and IV
+	         break;
+	      ofdm_input [ficno][index ++] = data [i];
 	      if (index >= 2304) {
-	         process_ficInput (ficno);
 	         index = 0;
 	         ficno ++;
 	      }
@@ -149,42 +158,100 @@ int32_t	i;
 	   fprintf (stderr, "You should not call ficBlock here\n");
 //	we are pretty sure now that after block 4, we end up
 //	with index = 0
+	if (blkno == 3)
+	   decodeFrame (ficno);
+#ifdef	__DECODER_TIMINGS
+	decodeTime	+= std::chrono::duration <double, std::micro>
+	                    (std::chrono::steady_clock::now () - t0). count ();
+#endif
+	if (blkno == 3)
+	   endofFrame ();
 }
 
-/**
-  *	\brief process_ficInput
-  *	we have a vector of 2304 (0 .. 2303) soft bits that has
-  *	to be de-punctured and de-conv-ed into a block of 768 bits
-  *	In this approach we first create the full 3072 block (i.e.
-  *	we first depuncture, and then we apply the deconvolution
-  *	In the next coding step, we will combine this function with the
-  *	one above
-  */
-void	ficHandler::process_ficInput (int16_t ficno) {
-int16_t	i;
-int16_t	viterbiBlock [3072 + 24];
-int16_t	inputCount	= 0;
+//
+//	Once the ensemble is known and the FIC was correct for
+//	STABLE_FRAMES frames in a row, only one of each dutyCycle
+//	frames is decoded. A CRC failure or an announced change in
+//	the configuration (FIG 0/0) brings back the full rate
+void	ficHandler::endofFrame	(void) {
+	if (frameCorrect && !changeAnnounced && syncReached ()) {
+	   if (goodFrames. load () < STABLE_FRAMES)
+	      goodFrames. fetch_add (1);
+	   else
+	      steady. store (true);
+	}
+	else {
+	   goodFrames. store (0);
+	   steady. store (false);
+	}
+	changeAnnounced	= false;
+	checkEnsemble ();
+#ifdef	__DECODER_TIMINGS
+	if (++decodedFrames + skippedFrames >= 1000) {
+	   double perFrame = decodeTime / decodedFrames;
+//	the frame duration (96, 24 or 48 msec) depends on the mode
+	   double perHour  = 3600.0 * INPUT_RATE / params. get_T_F ();
+	   fprintf (stderr,
+	            "fic: %d of %d frames decoded, %.1f usec per frame, saves %.1f sec per hour\n",
+	            decodedFrames, decodedFrames + skippedFrames, perFrame,
+	            perFrame * perHour * skippedFrames /
+	                   (decodedFrames + skippedFrames) / 1000000);
+	   decodedFrames	= 0;
+	   skippedFrames	= 0;
+	   decodeTime		= 0;
+	}
+#endif
+}
 
-	memset (viterbiBlock, 0, (3072 + 24) * sizeof (int16_t));
+void	ficHandler::setDutyCycle	(int16_t dutyCycle) {
+	this	-> dutyCycle	= dutyCycle < 1 ? 1 : dutyCycle;
+}
+//
+//	to be called once per frame, before its FIC blocks are
+//	handed over
+bool	ficHandler::frameNeeded	(void) {
+	if ((dutyCycle <= 1) || !steady. load ()) {
+	   frameCount	= 0;
+	   return true;
+	}
+	return ++frameCount % dutyCycle == 0;
+}
 
+void	ficHandler::fullRate	(void) {
+	goodFrames. store (0);
+	steady. store (false);
+}
 
-	for (i = 0; i < 3072 + 24; i ++)
-	   if (punctureTable [i])
-	      viterbiBlock [i] = ofdm_input [inputCount ++];
 /**
-  *	Now we have the full word ready for deconvolution
+  *	\brief decodeFrame
+  *	each 2304 (0 .. 2303) soft bits of the frame form a punctured
+  *	codeword of 3072 + 24 bits, to be de-punctured and de-conv-ed
+  *	into a block of 768 bits. The nrCodewords (4 for Mode I)
+  *	codewords are handed to the viterbi decoder as one batch,
   *	deconvolution is according to DAB standard section 11.2
   */
-	myViterbi. deconvolve (viterbiBlock, bitBuffer_out);
+void	ficHandler::decodeFrame	(int16_t nrCodewords) {
+int8_t	*inputs [4];
+uint8_t	*outputs [4];
+int16_t	c, i;
+
+	if (nrCodewords > 4)
+	   nrCodewords = 4;
+	for (c = 0; c < nrCodewords; c ++) {
+	   inputs [c]	= ofdm_input [c];
+	   outputs [c]	= bitBuffer_out [c];
+	}
+	myViterbi. deconvolve (inputs, &punctures, outputs, nrCodewords);
 /**
-  *	if everything worked as planned, we now have a
+  *	if everything worked as planned, we now have per codeword a
   *	768 bit vector containing three FIB's
   *
   *	first step: energy dispersal according to the DAB standard
   *	We use a predefined vector PRBS
   */
-	for (i = 0; i < 768; i ++)
-	   bitBuffer_out [i] ^= PRBS [i];
+	for (c = 0; c < nrCodewords; c ++) {
+	   for (i = 0; i < 768; i ++)
+	      bitBuffer_out [c][i] ^= PRBS [i];
 /**
   *	each of the fib blocks is protected by a crc
   *	(we know that there are three fib blocks each time we are here)
@@ -193,16 +260,17 @@ int16_t	inputCount	= 0;
   *	One issue is what to do when we really believe the synchronization
   *	was lost.
   */
+	   for (i = c * 3; i < c * 3 + 3; i ++) {
+	      uint8_t *p = &bitBuffer_out [c][(i % 3) * 256];
+	      if (!check_CRC_bits (p, 256)) {
+	         show_ficSuccess (false);
+	         frameCorrect	= false;
+	         continue;
+	      }
 
-	for (i = ficno * 3; i < ficno * 3 + 3; i ++) {
-	   uint8_t *p = &bitBuffer_out [(i % 3) * 256];
-	   if (!check_CRC_bits (p, 256)) {
-	      show_ficSuccess (false);
-	      continue;
+	      show_ficSuccess (true);
+	      fib_processor::process_FIB (p, c);
 	   }
-
-	   show_ficSuccess (true);
-	   fib_processor::process_FIB (p, ficno);
 	}
 }
 
@@ -210,6 +278,7 @@ void	ficHandler::stop (void) {
 }
 
 void	ficHandler::reset	(void) {
+	fullRate ();
 	clearEnsemble ();
 }
 
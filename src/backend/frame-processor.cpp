@@ -28,7 +28,7 @@
 	frameProcessor::~frameProcessor	(void) {
 }
 
-void	frameProcessor::addtoFrame	(std::vector<uint8_t> v) {
+void	frameProcessor::addtoFrame	(uint8_t *v) {
 	(void)v;
 	fprintf (stderr, "xxx");
 }
@@ -61,11 +61,14 @@
 	      numberofblocksperCIF	= 18;
 	      break;
 	}
+	neededBlocks	= new std::atomic<bool> [numberofblocksperCIF];
+	setNeededBlocks ();
 	work_to_be_done. store (false);
 }
 
 		mscHandler::~mscHandler	(void) {
 	reset ();
+	delete[] neededBlocks;
 }
 //
 //	This function is to be called between invocations of
@@ -80,8 +83,35 @@
 	      delete theBackends [i];
 	   }
 	   theBackends. resize (0);
+	   setNeededBlocks ();
 	   locker. unlock ();
 	}
+//
+//	A block (of a CIF) is needed when it carries one of the
+//	CU's of a backend. The ofdm decoder does not even transform
+//	and demodulate the other blocks.
+//	To be called with the locker taken
+void	mscHandler::setNeededBlocks	(void) {
+int16_t	i, j;
+	for (i = 0; i < numberofblocksperCIF; i ++)
+	   neededBlocks [i]. store (false);
+	for (j = 0; j < theBackends. size (); j ++) {
+	   int32_t startAddr	= theBackends [j] -> startAddr ();
+	   int16_t Length	= theBackends [j] -> Length    ();
+	   if (Length <= 0)
+	      continue;
+	   int32_t firstBlock	= startAddr * CUSize / BitsperBlock;
+	   int32_t lastBlock	= ((startAddr + Length) * CUSize - 1) /
+	                                                     BitsperBlock;
+	   for (i = firstBlock;
+	        (i <= lastBlock) && (i < numberofblocksperCIF); i ++)
+	      neededBlocks [i]. store (true);
+	}
+}
+
+bool	mscHandler::blockNeeded	(int16_t blkno) {
+	return neededBlocks [(blkno - 4) % numberofblocksperCIF]. load ();
+}
 
 //
 //	Note, the set_xxx functions are called from within a
@@ -98,6 +128,7 @@ void	mscHandler::set_audioChannel (audiodata *d,
 	                                          d,
 	                                          audioBuffer,
 	                                          picturesPath));
+	setNeededBlocks ();
 	work_to_be_done. store (true);
 	locker. unlock ();
 }
@@ -109,6 +140,7 @@ void	mscHandler::set_dataChannel (packetdata	*d,
 	                                         d,
 	                                         dataBuffer,
 	                                         picturesPath));
+	setNeededBlocks ();
 	work_to_be_done. store (true);
 	locker. unlock ();
 }
@@ -121,15 +153,16 @@ void	mscHandler::set_dataChannel (packetdata	*d,
 //
 //	Any change in the selected service will only be active
 //	during te next process_mscBlock call.
-void	mscHandler::process_mscBlock	(std::vector<int16_t> fbits,
+void	mscHandler::process_mscBlock	(int8_t *fbits,
 	                                 int16_t blkno) { 
 int16_t	currentblk;
 int16_t	i;
 
 	currentblk	= (blkno - 4) % numberofblocksperCIF;
 //	and the normal operation is:
-	memcpy (&cifVector [currentblk * BitsperBlock],
-	                    fbits. data (), BitsperBlock * sizeof (int16_t));
+	if (fbits != NULL)
+	   memcpy (&cifVector [currentblk * BitsperBlock],
+	                       fbits, BitsperBlock * sizeof (int8_t));
 	if (currentblk < numberofblocksperCIF - 1) 
 	   return;
 
@@ -139,16 +172,15 @@ int16_t	i;
 //	OK, now we have a full CIF and it seems there is some work to
 //	be done.  We assume that the backend itself
 //	does the work in a separate thread.
+//	The backends get a pointer into the cifVector, data they
+//	want to keep beyond the call has to be copied by them
 	locker. lock ();
 	for (i = 0; i < theBackends. size (); i ++) {
 	   int16_t startAddr	= theBackends [i] -> startAddr ();
 	   int16_t Length	= theBackends [i] -> Length    (); 
-	   if (Length > 0) {		// Length = 0? virtual Backend
-	      int16_t temp [Length * CUSize];
-	      memcpy (temp, &cifVector [startAddr * CUSize],
-	                           Length * CUSize * sizeof (int16_t));
-	      (void) theBackends [i] -> process (temp, Length * CUSize);
-	   }
+	   if (Length > 0) 		// Length = 0? virtual Backend
+	      (void) theBackends [i] -> process (&cifVector [startAddr * CUSize],
+	                                         Length * CUSize);
 	}
 	locker. unlock ();
 }
@@ -26,14 +26,14 @@
 #include	"protection.h"
 
        protection::protection  (int16_t bitRate, int16_t protLevel):
-                                        viterbi_768 (24 * bitRate, false),
-                                        outSize (24 * bitRate),
-	                                indexTable   (outSize * 4 + 24),
-                                        viterbiBlock (outSize * 4 + 24){
+                                        viterbi_768 (24 * bitRate, false,
+	                                             TRACEBACK_DEPTH),
+                                        outSize (24 * bitRate) {
 	this	-> bitRate	= bitRate;
+	punctures. nrRuns	= 0;
 }
 	protection::~protection	(void) {}
-bool	protection::deconvolve	(int16_t *a,
+bool	protection::deconvolve	(int8_t *a,
 	                         int32_t b, uint8_t *c) {
 	   (void)a; (void)b; (void)c;
 	   return false;
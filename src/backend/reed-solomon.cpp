@@ -7,6 +7,11 @@
 #include	<stdio.h>
 #include	"reed-solomon.h"
 #include	<string.h>
+#include	"cpu-features.h"
+#if defined (__SSE2__)
+#include	<immintrin.h>
+#define	TARGET_SSSE3	__attribute__ ((target ("ssse3")))
+#endif
 
 /*
  *	Reed-Solomon decoder
@@ -21,6 +26,11 @@
  */
 #define	min(a,b)	((a) < (b) ? (a) : (b))
 
+enum	{
+	KERNEL_SCALAR,
+	KERNEL_SSSE3
+};
+
 /* Initialize a Reed-Solomon codec
  * symsize	= symbol size, bits (1-8)
  * gfpoly	= Field generator polynomial coefficients
@@ -73,10 +83,37 @@ int i, j, root, iprim;
 	}
 	for (i = 0; i <= nroots; i ++)
 	   generator [i] = myGalois. poly2power (generator [i]);
+//
+//	the syndromes of a batch are computed with Horner, i.e. by
+//	multiplying with root i over and over again. Multiplying by
+//	a constant is a table lookup, with pshufb that is two lookups
+//	of 16 entries, for the low and for the high nibble
+	rootProducts	= new uint8_t [nroots * 256];
+	nibbleProducts	= new uint8_t [nroots * 32];
+	for (i = 0; i < nroots; i ++) {
+	   uint16_t power = myGalois. pow_power (
+	                           myGalois. multiply_power (fcr, i), prim);
+	   for (j = 0; j < 256; j ++)
+	      rootProducts [i * 256 + j] = j > codeLength ? 0 :
+	                   myGalois. multiply_poly (j,
+	                                  myGalois. power2poly (power));
+	   for (j = 0; j < 16; j ++) {
+	      nibbleProducts [i * 32 + j]	= rootProducts [i * 256 + j];
+	      nibbleProducts [i * 32 + 16 + j]	= 
+	                                  rootProducts [i * 256 + (j << 4)];
+	   }
+	}
+	kernel		= KERNEL_SCALAR;
+#if defined (__SSE2__)
+	if (cpu_hasSSSE3 () && (symsize == 8))
+	   kernel	= KERNEL_SSSE3;
+#endif
 }
 
 	reedSolomon::~reedSolomon	(void) {
-	delete generator;
+	delete[] generator;
+	delete[] rootProducts;
+	delete[] nibbleProducts;
 }
 
 //
@@ -144,6 +181,138 @@ int16_t	ret;
 
 int16_t	reedSolomon::decode_rs (uint8_t *data) {
 uint8_t syndromes [nroots];
+//
+//	returning syndromes in poly
+	if (computeSyndromes (data, syndromes))
+	   return 0;
+	return correctErrors (data, syndromes);
+}
+//
+//	With most superframes error free, the syndromes are computed
+//	for all codewords at once, the codewords are only taken
+//	apart for the Berlekamp-Massey, Chien and Forney steps when
+//	a syndrome is not zero
+int16_t	reedSolomon::decBatch	(uint8_t *data, int16_t n, int16_t cutlen) {
+int16_t	length	= codeLength - cutlen;
+uint8_t	syndromes [nroots * n];
+uint8_t	syn	[nroots];
+uint8_t	rf	[codeLength];
+int16_t	i, j, k;
+int16_t	corrected	= 0;
+
+	batchSyndromes (data, n, length, syndromes);
+	for (j = 0; j < n; j ++) {
+	   uint8_t syn_error	= 0;
+	   for (i = 0; i < nroots; i ++) {
+	      syn [i]	= syndromes [i * n + j];
+	      syn_error	|= syn [i];
+	   }
+	   if (syn_error == 0)
+	      continue;
+
+	   memset (rf, 0, cutlen * sizeof (rf [0]));
+	   for (k = 0; k < length; k ++)
+	      rf [cutlen + k] = data [j + k * n];
+	   int16_t ret	= correctErrors (rf, syn);
+	   if (ret < 0)
+	      return -1;
+	   for (k = 0; k < length - nroots; k ++)
+	      data [j + k * n] = rf [cutlen + k];
+	   corrected	+= ret;
+	}
+	return corrected;
+}
+
+#if defined (__SSE2__)
+//
+//	16 codewords per register, symbol k of the codewords is at
+//	data [k * stride]. All syndromes are updated per symbol, so
+//	the - long - chains of lookups of the roots overlap
+TARGET_SSSE3 static
+void	syndromes16	(const uint8_t *data, int16_t stride, int16_t length,
+	                 int16_t nroots, const uint8_t *nibbleProducts,
+	                 __m128i *syn) {
+const __m128i nibble	= _mm_set1_epi8 (0x0F);
+int16_t	i, k;
+
+	for (i = 0; i < nroots; i ++)
+	   syn [i] = _mm_setzero_si128 ();
+	for (k = 0; k < length; k ++) {
+	   __m128i symbols	= _mm_loadu_si128 ((__m128i *)
+	                                            &data [k * stride]);
+	   for (i = 0; i < nroots; i ++) {
+	      __m128i lo	= _mm_loadu_si128 ((__m128i *)
+	                                   &nibbleProducts [i * 32]);
+	      __m128i hi	= _mm_loadu_si128 ((__m128i *)
+	                                   &nibbleProducts [i * 32 + 16]);
+	      __m128i product =
+	           _mm_xor_si128 (
+	               _mm_shuffle_epi8 (lo, _mm_and_si128 (syn [i], nibble)),
+	               _mm_shuffle_epi8 (hi, _mm_and_si128 (
+	                          _mm_srli_epi16 (syn [i], 4), nibble)));
+	      syn [i]	= _mm_xor_si128 (product, symbols);
+	   }
+	}
+}
+//
+//	the last (n % 16) codewords are copied - padded with empty
+//	ones - to a buffer of 16 wide
+TARGET_SSSE3 static
+void	syndromesSSSE3	(const uint8_t *data, int16_t n, int16_t length,
+	                 int16_t nroots, const uint8_t *nibbleProducts,
+	                 uint8_t *syndromes) {
+__m128i	syn	[nroots];
+uint8_t	rest	[16 * length];
+uint8_t	result	[16];
+int16_t	i, j, k;
+
+	for (j = 0; j + 16 <= n; j += 16) {
+	   syndromes16 (&data [j], n, length, nroots, nibbleProducts, syn);
+	   for (i = 0; i < nroots; i ++)
+	      _mm_storeu_si128 ((__m128i *)&syndromes [i * n + j], syn [i]);
+	}
+	if (j >= n)
+	   return;
+	memset (rest, 0, 16 * length);
+	for (k = 0; k < length; k ++)
+	   memcpy (&rest [16 * k], &data [j + k * n], n - j);
+	syndromes16 (rest, 16, length, nroots, nibbleProducts, syn);
+	for (i = 0; i < nroots; i ++) {
+	   _mm_storeu_si128 ((__m128i *)result, syn [i]);
+	   memcpy (&syndromes [i * n + j], result, n - j);
+	}
+}
+#endif
+//
+//	syndrome i of codeword j goes to syndromes [i * n + j], the
+//	shortened part of the codewords - all zeros - does not
+//	contribute
+void	reedSolomon::batchSyndromes	(const uint8_t *data, int16_t n,
+	                                 int16_t length, uint8_t *syndromes) {
+int16_t	i, j, k;
+
+#if defined (__SSE2__)
+	if (kernel == KERNEL_SSSE3) {
+	   syndromesSSSE3 (data, n, length, nroots,
+	                          nibbleProducts, syndromes);
+	   return;
+	}
+#endif
+	for (j = 0; j < n; j ++) {
+	   uint8_t syn [nroots];
+	   memset (syn, 0, nroots);
+	   for (k = 0; k < length; k ++) {
+	      uint8_t symbol	= data [j + k * n];
+	      for (i = 0; i < nroots; i ++)
+	         syn [i] = rootProducts [i * 256 + syn [i]] ^ symbol;
+	   }
+	   for (i = 0; i < nroots; i ++)
+	      syndromes [i * n + j] = syn [i];
+	}
+}
+//
+//	the syndromes are in poly form and not all zero
+int16_t	reedSolomon::correctErrors	(uint8_t *data, uint8_t *syndromes) {
 uint8_t Lambda	  [nroots + 1];
 uint16_t lambda_degree, omega_degree;
 uint8_t	rootTable [nroots];
@@ -151,10 +320,7 @@ uint8_t	locTable  [nroots];
 uint8_t	omega	  [nroots + 1];
 int16_t	rootCount;
 int16_t	i;
-//
-//	returning syndromes in poly
-	if (computeSyndromes (data, syndromes))
-	   return 0;
+
 //	Step 2: Berlekamp-Massey
 //	Lambda in power notation
 	lambda_degree = computeLambda (syndromes, Lambda);
@@ -252,7 +418,7 @@ int16_t j;
 //	use Horner to compute the syndromes
 bool	reedSolomon::computeSyndromes (uint8_t *data, uint8_t *syndromes) {
 int16_t i;
-uint16_t syn_error;
+uint16_t syn_error	= 0;
 
 /* form the syndromes; i.e., evaluate data (x) at roots of g(x) */
 
@@ -271,7 +437,7 @@ uint16_t reedSolomon::computeLambda (uint8_t *syndromes, uint8_t *Lambda) {
 uint16_t K = 1, L = 0;
 uint8_t Corrector	[nroots];
 int16_t  i;
-int16_t	deg_lambda;
+int16_t	deg_lambda	= 0;
 
 	for (i = 0; i < nroots; i ++)
 	   Corrector [i] = Lambda [i] = 0;
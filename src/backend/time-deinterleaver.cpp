@@ -0,0 +1,173 @@
+#
+/*
+ *    Copyright (C) 2013 .. 2017
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	<string.h>
+#include	"time-deinterleaver.h"
+#include	"cpu-features.h"
+#if defined (__SSE2__)
+#include	<immintrin.h>
+#define	TARGET_AVX2	__attribute__ ((target ("avx2")))
+#endif
+#ifdef  __MINGW32__
+#include	<malloc.h>
+#endif
+
+static const
+int16_t interleaveMap [] = {0,8,4,12,2,10,6,14,1,9,5,13,3,11,7,15};
+
+enum	{
+	KERNEL_SCALAR,
+	KERNEL_SSE2,
+	KERNEL_AVX2
+};
+//
+//	the size of a subchannel is a multiple of CUSize (64) soft bits,
+//	so it is a whole number of groups. The 16 masks follow the
+//	delay line, in the same (aligned) allocation
+	timeDeinterleaver::timeDeinterleaver (int32_t size) {
+	this	-> size		= size;
+	groups			= size / DEINTERLEAVE_GROUP;
+	index			= 0;
+	count			= 0;
+	kernel			= KERNEL_SCALAR;
+#if defined (__SSE2__)
+	kernel			= cpu_hasAVX2 () ? KERNEL_AVX2 : KERNEL_SSE2;
+#endif
+#ifdef	__MINGW32__
+	delayLine	= (int8_t *)_aligned_malloc ((groups + 1) * 16 *
+	                                          DEINTERLEAVE_GROUP, 32);
+#else
+	if (posix_memalign ((void **)&delayLine, 32,
+	                     (groups + 1) * 16 * DEINTERLEAVE_GROUP))
+	   fprintf (stderr, "Allocation of delay line failed\n");
+#endif
+	memset (delayLine, 0, groups * 16 * DEINTERLEAVE_GROUP);
+	masks		= &delayLine [groups * 16 * DEINTERLEAVE_GROUP];
+}
+
+	timeDeinterleaver::~timeDeinterleaver (void) {
+#ifdef	__MINGW32__
+	_aligned_free (delayLine);
+#else
+	free (delayLine);
+#endif
+}
+
+#if defined (__SSE2__)
+//
+//	per block the row of the incoming CIF is read (as one of the
+//	16) before it is overwritten
+TARGET_AVX2 static
+void	pickAVX2	(int8_t *line, const int8_t *in, int8_t *out,
+	                 int32_t groups, int16_t index,
+	                 const int8_t *masks) {
+int32_t	g, r;
+
+	for (g = 0; g < groups; g ++) {
+	   __m256i *block	= (__m256i *)&line [g * 16 * DEINTERLEAVE_GROUP];
+	   __m256i acc		= _mm256_setzero_si256 ();
+	   for (r = 0; r < 16; r ++)
+	      acc = _mm256_or_si256 (acc,
+	                 _mm256_and_si256 (_mm256_load_si256 (&block [r]),
+	                                   _mm256_load_si256 ((__m256i *)
+	                                  &masks [r * DEINTERLEAVE_GROUP])));
+	   _mm256_storeu_si256 ((__m256i *)&out [g * DEINTERLEAVE_GROUP], acc);
+	   _mm256_store_si256 (&block [index],
+	                       _mm256_loadu_si256 ((__m256i *)
+	                                &in [g * DEINTERLEAVE_GROUP]));
+	}
+}
+
+static
+void	pickSSE2	(int8_t *line, const int8_t *in, int8_t *out,
+	                 int32_t groups, int16_t index,
+	                 const int8_t *masks) {
+int32_t	g, r, h;
+
+	for (g = 0; g < groups; g ++) {
+	   for (h = 0; h < DEINTERLEAVE_GROUP / 16; h ++) {
+	      int8_t *base	= &line [g * 16 * DEINTERLEAVE_GROUP + 16 * h];
+	      __m128i acc	= _mm_setzero_si128 ();
+	      for (r = 0; r < 16; r ++)
+	         acc = _mm_or_si128 (acc,
+	                 _mm_and_si128 (_mm_load_si128 ((__m128i *)
+	                                   &base [r * DEINTERLEAVE_GROUP]),
+	                                _mm_load_si128 ((__m128i *)
+	                                   &masks [r * DEINTERLEAVE_GROUP + 16 * h])));
+	      int32_t pos	= g * DEINTERLEAVE_GROUP + 16 * h;
+	      _mm_storeu_si128 ((__m128i *)&out [pos], acc);
+	      _mm_store_si128 ((__m128i *)&base [index * DEINTERLEAVE_GROUP],
+	                       _mm_loadu_si128 ((__m128i *)&in [pos]));
+	   }
+	}
+}
+#endif
+
+static
+void	pickScalar	(int8_t *line, const int8_t *in, int8_t *out,
+	                 int32_t groups, int16_t index) {
+int16_t	offset [DEINTERLEAVE_GROUP];
+int32_t	g, j;
+
+	for (j = 0; j < DEINTERLEAVE_GROUP; j ++)
+	   offset [j] = ((index + interleaveMap [j & 017]) & 017) *
+	                                   DEINTERLEAVE_GROUP + j;
+	for (g = 0; g < groups; g ++) {
+	   int8_t *block	= &line [g * 16 * DEINTERLEAVE_GROUP];
+	   for (j = 0; j < DEINTERLEAVE_GROUP; j ++)
+	      out [g * DEINTERLEAVE_GROUP + j] = block [offset [j]];
+	   memcpy (&block [index * DEINTERLEAVE_GROUP],
+	           &in [g * DEINTERLEAVE_GROUP], DEINTERLEAVE_GROUP);
+	}
+}
+//
+//	soft bit i comes from the CIF in row (index + map [i % 16]) % 16,
+//	i.e. with a delay of 16 - map [i % 16] CIF's
+bool	timeDeinterleaver::process	(const int8_t *in, int8_t *out) {
+int16_t	j;
+
+	memset (masks, 0, 16 * DEINTERLEAVE_GROUP);
+	for (j = 0; j < DEINTERLEAVE_GROUP; j ++)
+	   masks [((index + interleaveMap [j & 017]) & 017) *
+	                                   DEINTERLEAVE_GROUP + j] = -1;
+	switch (kernel) {
+#if defined (__SSE2__)
+	   case KERNEL_AVX2:
+	      pickAVX2 (delayLine, in, out, groups, index, masks);
+	      break;
+	   case KERNEL_SSE2:
+	      pickSSE2 (delayLine, in, out, groups, index, masks);
+	      break;
+#endif
+	   default:
+	      pickScalar (delayLine, in, out, groups, index);
+	      break;
+	}
+	index	= (index + 1) & 017;
+	if (count < 16) {
+	   count ++;
+	   return false;
+	}
+	return true;
+}
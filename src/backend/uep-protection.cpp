@@ -143,8 +143,7 @@ int16_t	i;
      uep_protection::uep_protection (int16_t bitRate,
                                         int16_t protLevel):
                                             protection (bitRate, protLevel) {
-int16_t index, i, j;
-int16_t	viterbiCounter	= 0;
+int16_t index;
 int16_t         L1;
 int16_t         L2;
 int16_t         L3;
@@ -177,69 +176,28 @@ int8_t          *PI_X;
 
 	PI_X	= get_PCodes (8 - 1);
 //
-//	We prepare a mapping table with the given punctures
-	memset (indexTable. data (), 0, (4 * outSize + 24) * sizeof (uint8_t));
-	for (i = 0; i < L1; i ++) {
-	   for (j = 0; j < 128; j ++) {
-	      if (PI1 [j % 32] != 0) 
-	         indexTable [viterbiCounter] = true;
-	      viterbiCounter ++;
-	   }
-	}
-
-	for (i = 0; i < L2; i ++) {
-	   for (j = 0; j < 128; j ++) {
-	      if (PI2 [j % 32] != 0) 
-	         indexTable [viterbiCounter] = true;
-	      viterbiCounter ++;
-	   }
-	}
-
-	for (i = 0; i < L3; i ++) {
-	   for (j = 0; j < 128; j ++) {
-	      if (PI3 [j % 32] != 0) 
-	         indexTable [viterbiCounter] = true;
-	      viterbiCounter ++;	
-	   }
-	}
-
+//	We describe the punctures as runs of L * 128 bits
+	addRun (&punctures, L1 * 128, PI1);
+	addRun (&punctures, L2 * 128, PI2);
+	addRun (&punctures, L3 * 128, PI3);
 	if (PI4 != NULL)
-	   for (i = 0; i < L4; i ++) {
-	      for (j = 0; j < 128; j ++) {
-	         if (PI4 [j % 32] != 0) 
-	            indexTable [viterbiCounter] = true;
-	         viterbiCounter ++;	
-	      }
-	   }
-
+	   addRun (&punctures, L4 * 128, PI4);
 /**
   *	we have a final block of 24 bits  with puncturing according to PI_X
   *	This block constitues the 6 * 4 bits of the register itself.
   */
-	for (i = 0; i < 24; i ++) {
-	   if (PI_X [i] != 0)  
-	      indexTable [viterbiCounter] = true;
-	   viterbiCounter ++;
-	}
+	addRun (&punctures, 24, PI_X);
 }
 
 	uep_protection::~uep_protection (void) {
 }
 
-bool	uep_protection::deconvolve (int16_t *v,
+bool	uep_protection::deconvolve (int8_t *v,
 	                            int32_t size,
 	                            uint8_t *outBuffer) {
-int16_t	i;
-int16_t	inputCounter	= 0;
-//	clear the bits in the viterbiBlock,
-//	only the non-punctured ones are set
-	memset (viterbiBlock. data (), 0,
-	                        (outSize * 4 + 24) * sizeof (int16_t)); 
-///	The actual deconvolution is done by the viterbi decoder
-
-	for (i = 0; i < outSize * 4 + 24; i ++)
-	   if (indexTable [i])
-	      viterbiBlock [i] = v [inputCounter ++];
-	viterbi_768::deconvolve (viterbiBlock. data (), outBuffer);
+	(void)size;
+///	The actual deconvolution - and the depuncturing - is done
+///	by the viterbi decoder, the punctured bits are erasures
+	viterbi_768::deconvolvePacked (v, &punctures, outBuffer);
 	return true;
 }
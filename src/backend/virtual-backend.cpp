@@ -33,7 +33,7 @@
 	virtualBackend::~virtualBackend	(void) {
 }
 
-int32_t	virtualBackend::process	(int16_t *v, int16_t c) {
+int32_t	virtualBackend::process	(int8_t *v, int16_t c) {
 	(void)v;
 	(void)c;
 	return 32768;
@@ -1,4 +1,4 @@
-#if !defined(NEON_AVAILABLE) && !defined(NEON_AVAILABLE)
+#if !defined(NEON_AVAILABLE) && !defined(__SSE2__)
 /***************************************************************
 This code was generated by Spiral 6.0 beta, www.spiral.net --
 Copyright (c) 2005-2008, Carnegie Mellon University.
@@ -1,3 +1,4 @@
+#if defined(__SSE2__) && !defined(NEON_AVAILABLE)
 /***************************************************************
 This code was generated by Spiral 6.0 beta, www.spiral.net --
 Copyright (c) 2005-2008, Carnegie Mellon University.
@@ -696,3 +697,4 @@ int i9;
     }
     /* skip */
 }
+#endif
@@ -28,6 +28,14 @@
 #include	"mm_malloc.h"
 #include	"viterbi-768.h"
 #include	<cstring>
+#include	"cpu-features.h"
+#ifdef	__DECODER_TIMINGS
+#include	<chrono>
+#endif
+#if defined (__SSE2__)
+#include	<immintrin.h>
+#define	TARGET_AVX2	__attribute__ ((target ("avx2")))
+#endif
 #ifdef  __MINGW32__
 #include	<intrin.h>
 #include	<malloc.h>
@@ -45,6 +53,26 @@
 //#define POLYS { 0133, 0171, 0145, 0133 }
 //#define POLYS { 91, 121, 101, 91 }
 
+//
+//	The kernels for the update of the path metrics. The AVX2 one
+//	is compiled in on all x86 machines and selected when cpuid
+//	says so, SSE2 is there anyway. The spiral code is generated
+//	for plain C, SSE2 or - as build option - NEON
+enum	{
+	KERNEL_SPIRAL,
+	KERNEL_SSE2,
+	KERNEL_AVX2
+};
+
+#if defined (NEON_AVAILABLE)
+#define	SPIRAL_NAME	"spiral-neon"
+#elif defined (__SSE2__)
+#define	SPIRAL_NAME	"spiral-sse"
+#else
+#define	SPIRAL_NAME	"spiral-no-sse"
+#endif
+static const char *kernelNames [] = {SPIRAL_NAME, "sse2", "avx2"};
+
 #define	METRICSHIFT	0
 #define	PRECISIONSHIFT	0
 #define	RENORMALIZE_THRESHOLD	137
@@ -125,45 +153,85 @@ int32_t	i;
 //	The main use of the viterbi decoder is in handling the FIC blocks
 //	There are (in mode 1) 3 ofdm blocks, giving 4 FIC blocks
 //	There all have a predefined length. In that case we use the
-//	"fast" (i.e. spiral) code, otherwise we use the generic code
-	viterbi_768::viterbi_768 (int16_t wordlength, bool spiral) {
+//	"fast" (i.e. spiral) code, otherwise we use the SSE2 code
+//	or - without SSE2 - the spiral code as well.
+//	With AVX2 available, that one is used for both.
+//	All kernels give the same decisions as the generic code,
+//	which is kept as reference.
+//	With a traceback depth the decisions are kept for no more
+//	than 4 * depth steps and the bits come out per window of
+//	2 * depth steps, with depth 0 the whole codeword is kept
+	viterbi_768::viterbi_768 (int16_t wordlength, bool spiral,
+	                                              int16_t depth) {
 int polys [RATE] = POLYS;
 int16_t	i, state;
+static bool reported [2]	= {false, false};
 #ifdef	__MINGW32__
 uint32_t	size;
 #endif
 
 	frameBits		= wordlength;
 	this	-> spiral	= spiral;
+//	a window is a multiple of 8 steps, i.e. of 32 symbols,
+//	a window that would cover the codeword is no window
+	depth			= (depth + 7) & ~07;
+	if (2 * depth >= wordlength + (K - 1))
+	   depth		= 0;
+	this	-> depth	= depth;
+	window			= 2 * depth;
+	ringSize		= depth == 0 ? 2 * (wordlength + (K - 1)) :
+	                                       2 * window;
+	kernel			= KERNEL_SPIRAL;
+#if defined (__SSE2__)
+	if (cpu_hasAVX2 ())
+	   kernel	= KERNEL_AVX2;
+	else
+	if (!spiral)
+	   kernel	= KERNEL_SSE2;
+#endif
+	if (!reported [spiral]) {
+	   fprintf (stderr, "viterbi: %s kernel for the %s\n",
+	                    kernelNames [kernel], spiral ? "FIC" : "MSC");
+	   reported [spiral]	= true;
+	}
+#ifdef	__DECODER_TIMINGS
+	decodeTime		= 0;
+	decodeWords		= 0;
+	decodeCount		= 0;
+#endif
 //	partab_init	();
 
 // B I G N O T E	The spiral code uses (wordLength + (K - 1) * sizeof ...
 // However, the application then crashes, so something is not OK
-// By doubling the size, the problem disappears. It is not solved though
-// and not further investigation.
+// By doubling the size, the problem disappears.
+// The cause was that the spiral code does two steps per round, and
+// was asked for as many rounds as there are steps. The sizes are kept.
+//	windowed, the symbols are made per window
+	symbolSteps	= depth == 0 ? wordlength + (K - 1) : window;
 #ifdef __MINGW32__
 	size = 2 * ((wordlength + (K - 1)) / 8 + 1 + 16) & ~0xF;
 	data	= (uint8_t *)_aligned_malloc (size, 16);
-	size = 2 * (RATE * (wordlength + (K - 1)) * sizeof(COMPUTETYPE) + 16) & ~0xF;
+	size = 2 * (RATE * symbolSteps * sizeof(COMPUTETYPE) + 16) & ~0xF;
 	symbols	= (COMPUTETYPE *)_aligned_malloc (size, 16);
-	size	= 2 * (wordlength + (K - 1)) * sizeof (decision_t);	
+	size	= ringSize * sizeof (decision_t);	
 	size	= (size + 16) & ~0xF;
-	vp. decisions = (decision_t  *)_aligned_malloc (size, 16);
+	decisionBase = (decision_t  *)_aligned_malloc (size, 16);
 #else
 	if (posix_memalign ((void**)&data, 16,
 	                        (wordlength + (K - 1))/ 8 + 1)){
 	   printf("Allocation of data array failed\n");
 	}
 	if (posix_memalign ((void**)&symbols, 16,
-	                     RATE * (wordlength + (K - 1)) * sizeof(COMPUTETYPE))){
+	                     RATE * symbolSteps * sizeof(COMPUTETYPE))){
 	   printf("Allocation of symbols array failed\n");
 	}
-	if (posix_memalign ((void**)&(vp. decisions),
+	if (posix_memalign ((void**)&decisionBase,
 	                    16,
-	                    2 * (wordlength + (K - 1)) * sizeof (decision_t))){
+	                    ringSize * sizeof (decision_t))){
 	   printf ("Allocation of vp decisions failed\n");
 	}
 #endif
+	vp. decisions	= decisionBase;
 
 	for (state = 0; state < NUMSTATES / 2; state++) {
 	   for (i = 0; i < RATE; i++)
@@ -171,6 +239,8 @@ uint32_t	size;
 	                     (polys[i] < 0) ^
 	                        parity((2 * state) & abs (polys[i])) ? 255 : 0;
 	}
+	for (i = 0; i < NUMSTATES / 2 * RATE; i ++)
+	   Branchtab16 [i] = Branchtab [i];
 //
 	init_viterbi (&vp, 0);
 }
@@ -178,11 +248,11 @@ uint32_t	size;
 
 	viterbi_768::~viterbi_768	(void) {
 #ifdef	__MINGW32__
-	_aligned_free (vp. decisions);
+	_aligned_free (decisionBase);
 	_aligned_free (data);
 	_aligned_free (symbols);
 #else
-	free (vp. decisions);
+	free (decisionBase);
 	free (data);
 	free (symbols);
 #endif
@@ -220,28 +290,288 @@ uint8_t getbit (uint8_t v, int32_t o) {
 //	}
 //}
 
+void	addRun	(struct puncturing *p, int32_t length, const int8_t *PI) {
+uint32_t	pattern	= 0;
+int16_t	j;
+
+	if (p -> nrRuns >= MAX_RUNS) {
+	   fprintf (stderr, "too many runs in puncturing scheme\n");
+	   return;
+	}
+	for (j = 0; j < 32; j ++)
+	   if (PI [j] != 0)
+	      pattern |= (uint32_t)1 << j;
+	p -> runs [p -> nrRuns]. length		= length;
+	p -> runs [p -> nrRuns]. pattern	= pattern;
+	p -> nrRuns ++;
+}
+
 //	Note that our DAB environment maps the softbits to -127 .. 127
-//	we have to map that onto 0 .. 255
+//	we have to map that onto 0 .. 254, only a - saturated - -128
+//	has to be clipped
+static inline
+COMPUTETYPE	toSymbol	(int8_t v) {
+int16_t	temp	= v + 127;
+	return temp < 0 ? 0 : temp;
+}
+//
+//	a punctured position is an erasure, it gets the symbol of a
+//	zero soft bit
+#define	ERASURE	127
 
-void	viterbi_768::deconvolve	(int16_t *input, uint8_t *output) {
-uint32_t	i;
+void	viterbi_768::deconvolve	(int8_t *input, uint8_t *output) {
+	deconvolve (&input, NULL, &output, 1);
+}
+//
+//	input contains the soft bits as transmitted, i.e. without
+//	the ones punctured away according to p
+void	viterbi_768::deconvolve	(int8_t *input,
+	                         const struct puncturing *p,
+	                         uint8_t *output) {
+	deconvolve (&input, p, &output, 1);
+}
+//
+//	A batch of n codewords, each of frameBits bits, such as the
+//	codewords of the FIC of a frame. Running two or four codewords
+//	side by side through the SIMD kernels was tried, the kernels
+//	are bound by the number of instructions rather than by their
+//	latency, so that gave nothing. The codewords are decoded
+//	one after the other, the batch is the unit of the timing
+void	viterbi_768::deconvolve	(int8_t **inputs,
+	                         const struct puncturing *p,
+	                         uint8_t **outputs, int16_t n) {
+	decodeBatch (inputs, p, outputs, n, false);
+}
+//
+//	The MSC data is handled as bytes anyway, the traceback
+//	packs the bits - msb first - while going back
+void	viterbi_768::deconvolvePacked	(int8_t *input,
+	                                 const struct puncturing *p,
+	                                 uint8_t *output) {
+	decodeBatch (&input, p, &output, 1, true);
+}
 
-	init_viterbi (&vp, 0);
-	for (i = 0; i < (uint16_t)(frameBits + (K - 1)) * RATE; i ++) {
-	   int16_t temp = input [i] + 127;
-	   if (temp < 0) temp = 0;
-	   if (temp > 255) temp = 255;
-	   symbols [i] = temp;
+void	viterbi_768::decodeBatch	(int8_t **inputs,
+	                         const struct puncturing *p,
+	                         uint8_t **outputs, int16_t n, bool packed) {
+int16_t	c;
+#ifdef	__DECODER_TIMINGS
+	auto t0	= std::chrono::steady_clock::now ();
+#endif
+	for (c = 0; c < n; c ++)
+	   decodeWord (inputs [c], p, outputs [c], packed);
+#ifdef	__DECODER_TIMINGS
+	decodeTime	+= std::chrono::duration <double, std::micro>
+	                    (std::chrono::steady_clock::now () - t0). count ();
+	decodeWords	+= n;
+	if (++decodeCount >= 1000) {
+	   fprintf (stderr,
+	            "viterbi (%s): %.2f Mbit/s per core, %.1f codewords per batch, %d bytes\n",
+	            kernelNames [kernel],
+	            (double)decodeWords * frameBits / decodeTime,
+	            (double)decodeWords / decodeCount,
+	            footprint ());
+	   decodeTime	= 0;
+	   decodeWords	= 0;
+	   decodeCount	= 0;
 	}
-	if (!spiral)
-	   update_viterbi_blk_GENERIC (&vp, symbols, frameBits + (K - 1));
-	else
-	   update_viterbi_blk_SPIRAL (&vp, symbols, frameBits + (K - 1));
+#endif
+}
+
+//
+//	The depuncturing is done while filling the symbols, there is
+//	no depunctured copy of the input. The symbols are made in
+//	pieces, startSymbols sets the cursor, nextSymbols fills the
+//	next n symbols.
+//	Per run the pattern gives for each of the 32 positions the
+//	offset of its input in the group and whether it is kept,
+//	a punctured position reads the first input of the group and
+//	multiplies it by 0, so a group of 32 has no branches
+void	viterbi_768::startSymbols	(int8_t *input,
+	                                 const struct puncturing *p) {
+	symbolInput	= input;
+	symbolPunctures	= p;
+	symbolRun	= 0;
+	symbolPos	= 0;
+}
+
+void	viterbi_768::nextSymbols	(COMPUTETYPE *out, int32_t n) {
+const struct puncturing *p	= symbolPunctures;
+int8_t	*input	= symbolInput;
+int32_t	i, j;
 
-	chainback_viterbi (&vp, data, frameBits, 0);
+	if (p == NULL) {
+	   for (i = 0; i < n; i ++)
+	      out [i] = toSymbol (input [i]);
+	   symbolInput	+= n;
+	   return;
+	}
 
-	for (i = 0; i < (uint16_t)frameBits; i ++)
-	   output [i] = getbit (data [i >> 3], i & 07);
+	while (n > 0) {
+	   if (symbolRun >= p -> nrRuns) {
+	      while (n -- > 0)
+	         *out ++ = ERASURE;
+	      break;
+	   }
+	   uint32_t pattern	= p -> runs [symbolRun]. pattern;
+	   int32_t length	= p -> runs [symbolRun]. length;
+	   int32_t todo		= length - symbolPos < n ?
+	                                    length - symbolPos : n;
+	   uint8_t	offset [32];
+	   int16_t	keep [32];
+	   int16_t	count	= 0;
+	   for (j = 0; j < 32; j ++) {
+	      keep [j]	= (pattern >> j) & 1;
+	      offset [j]	= keep [j] ? count : 0;
+	      count		+= keep [j];
+	   }
+	   for (i = 0; (i < todo) && (((symbolPos + i) & 31) != 0); i ++)
+	      *out ++ = keep [(symbolPos + i) & 31] ?
+	                            toSymbol (*input ++) : ERASURE;
+	   for (; (count > 0) && (i + 32 <= todo); i += 32) {
+	      for (j = 0; j < 32; j ++)
+	         out [j] = toSymbol (input [offset [j]] * keep [j]);
+	      out	+= 32;
+	      input	+= count;
+	   }
+	   for (; i < todo; i ++)
+	      *out ++ = keep [(symbolPos + i) & 31] ?
+	                            toSymbol (*input ++) : ERASURE;
+	   symbolPos	+= todo;
+	   n		-= todo;
+	   if (symbolPos >= length) {
+	      symbolRun ++;
+	      symbolPos	= 0;
+	   }
+	}
+	symbolInput	= input;
+}
+
+void	viterbi_768::updateMetrics	(int16_t nbits) {
+	switch (kernel) {
+#if defined (__SSE2__)
+	   case KERNEL_AVX2:
+	      update_viterbi_blk_AVX2 (&vp, symbols, nbits);
+	      break;
+	   case KERNEL_SSE2:
+	      update_viterbi_blk_SSE2 (&vp, symbols, nbits);
+	      break;
+#endif
+	   default:
+	      update_viterbi_blk_SPIRAL (&vp, symbols, nbits);
+	      break;
+	}
+}
+
+void	viterbi_768::decodeWord	(int8_t *input,
+	                         const struct puncturing *p,
+	                         uint8_t *output, bool packed) {
+int32_t	steps	= frameBits + (K - 1);
+int32_t	i;
+
+	init_viterbi (&vp, 0);
+	startSymbols (input, p);
+	if (depth == 0) {
+	   vp. decisions	= decisionBase;
+	   nextSymbols (symbols, steps * RATE);
+	   updateMetrics (steps);
+	   chainback_viterbi (&vp, packed ? output : data, frameBits, 0);
+	   if (packed)
+	      return;
+
+	   for (i = 0; i < frameBits; i ++)
+	      output [i] = getbit (data [i >> 3], i & 07);
+	   return;
+	}
+//
+//	windowed: the decisions of the last 2 * window steps are kept
+//	in a ring. After each window we trace back from the best
+//	state, the first depth steps of the path are there to
+//	converge, the bits of the steps before are final. A traceback
+//	covers window + depth steps and gives window bits.
+//	The last window ends in the - known - state 0.
+//	Packed, a traceback ends at a byte boundary, so each byte
+//	is written by one traceback only
+int32_t	step	= 0;
+int32_t	emitted	= 0;	// the bits of the steps before are out
+	while (step < steps) {
+	   int32_t n	= steps - step < window ? steps - step : window;
+	   nextSymbols (symbols, n * RATE);
+	   vp. decisions	= decisionBase + step % ringSize;
+	   updateMetrics (n);
+	   step	+= n;
+	   if (step == steps)
+	      traceback (0, step, emitted, step, output, packed);
+	   else {
+	      int32_t upto	= step - depth;
+	      if (packed)
+	         upto	= ((upto - (K - 1)) & ~07) + (K - 1);
+	      if (upto > emitted) {
+	         traceback (bestState (), step, emitted, upto,
+	                                             output, packed);
+	         emitted	= upto;
+	      }
+	   }
+	}
+}
+//
+//	trace back from state at step "from" down to step "to", the
+//	decision of step s gives bit s - (K - 1), these bits are
+//	written for the steps below emitBelow.
+//	Packed, as in chainback_viterbi, the state is kept with ADDSHIFT
+//	bits more, so it holds the last 8 bits, and it is stored for
+//	each bit, the store at the first bit of a byte is the one
+//	that stays
+void	viterbi_768::traceback	(uint16_t state, int32_t from,
+	                         int32_t to, int32_t emitBelow,
+	                         uint8_t *output, bool packed) {
+int32_t	s	= from - 1;
+int32_t	index	= s % ringSize;
+uint32_t k;
+
+	if (emitBelow < K - 1)
+	   emitBelow	= K - 1;
+	if (to < K - 1)
+	   to		= K - 1;
+	if (packed) {
+	   state	<<= ADDSHIFT;
+	   for (; s >= to; s --) {
+	      k	= (decisionBase [index]. w [state >> (5 + ADDSHIFT)] >>
+	                          ((state >> ADDSHIFT) & 31)) & 1;
+	      state	= (state >> 1) | (k << (K - 2 + ADDSHIFT));
+	      if (s < emitBelow)
+	         output [(s - (K - 1)) >> 3] = state >> SUBSHIFT;
+	      index	= index == 0 ? ringSize - 1 : index - 1;
+	   }
+	   return;
+	}
+	for (; s >= to; s --) {
+	   k	= (decisionBase [index]. w [state >> 5] >> (state & 31)) & 1;
+	   state	= (state >> 1) | (k << (K - 2));
+	   if (s < emitBelow)
+	      output [s - (K - 1)] = k;
+	   index	= index == 0 ? ringSize - 1 : index - 1;
+	}
+}
+//
+//	lowest path metric, the SIMD kernels leave 16 bit wrapped
+//	metrics, their spread is small so the difference decides
+uint16_t	viterbi_768::bestState	(void) {
+COMPUTETYPE *m	= vp. old_metrics -> t;
+uint16_t	best	= 0;
+int16_t	i;
+
+	for (i = 1; i < NUMSTATES; i ++)
+	   if ((int16_t)(m [i] - m [best]) < 0)
+	      best = i;
+	return best;
+}
+//
+//	bytes taken by the buffers that grow with the codeword
+int32_t	viterbi_768::footprint	(void) {
+	return ringSize * sizeof (decision_t) +
+	       RATE * symbolSteps * sizeof (COMPUTETYPE) +
+	       (depth == 0 ? (frameBits + (K - 1)) / 8 + 1 : 0);
 }
 
 /* C-language butterfly */
@@ -299,11 +629,148 @@ int32_t  s, i;
 	}
 }
 
+#if defined (__SSE2__)
+//
+//	The SIMD versions of update_viterbi_blk_GENERIC, they give the
+//	same decisions for any number of bits.
+//	The path metrics are kept in 16 bit lanes and are never
+//	renormalized: with K = 7 the metrics of the 64 states differ
+//	by no more than (K - 1) * RATE * 255, so comparing them by the
+//	sign of their - wrapping - 16 bit difference is exact.
+//	As in BFLY, for butterfly i (0 .. 31) the new states 2 * i and
+//	2 * i + 1 come from the old states i and i + 32, the decision
+//	bit for new state j is bit j of the (64 bit) decision word.
+//
+//	AVX2: the 32 butterflies of a step in two registers of 16 lanes
+TARGET_AVX2
+void	viterbi_768::update_viterbi_blk_AVX2 (struct v *vp,
+	                                      COMPUTETYPE *syms,
+	                                      int16_t nbits) {
+decision_t *d = (decision_t *)vp -> decisions;
+int16_t	start [NUMSTATES] __attribute__ ((aligned (32)));
+int32_t	s, i, k;
+__m256i	m [4];		// 16 states per register
+__m256i	nm [4];
+const __m256i max	= _mm256_set1_epi16 (RATE * 255);
+const __m256i zero	= _mm256_setzero_si256 ();
+
+	for (i = 0; i < NUMSTATES; i ++)
+	   start [i] = vp -> old_metrics -> t [i];
+	for (i = 0; i < 4; i ++)
+	   m [i] = _mm256_load_si256 ((__m256i *)&start [16 * i]);
+
+	for (s = 0; s < nbits; s ++) {
+	   __m256i sym [RATE];
+	   uint64_t decisions	= 0;
+	   for (i = 0; i < RATE; i ++)
+	      sym [i] = _mm256_set1_epi16 (syms [s * RATE + i]);
+
+	   for (k = 0; k < 2; k ++) {	// butterflies 16 * k .. 16 * k + 15
+	      __m256i metric	= zero;
+	      for (i = 0; i < RATE; i ++)
+	         metric = _mm256_add_epi16 (metric,
+	                    _mm256_xor_si256 (sym [i],
+	                        _mm256_loadu_si256 ((__m256i *)
+	                         &Branchtab16 [i * NUMSTATES / 2 + 16 * k])));
+	      __m256i other	= _mm256_sub_epi16 (max, metric);
+	      __m256i m0	= _mm256_add_epi16 (m [k], metric);
+	      __m256i m1	= _mm256_add_epi16 (m [k + 2], other);
+	      __m256i m2	= _mm256_add_epi16 (m [k], other);
+	      __m256i m3	= _mm256_add_epi16 (m [k + 2], metric);
+	      __m256i d0	= _mm256_cmpgt_epi16 (_mm256_sub_epi16 (m0, m1),
+	                                              zero);
+	      __m256i d1	= _mm256_cmpgt_epi16 (_mm256_sub_epi16 (m2, m3),
+	                                              zero);
+	      __m256i s0	= _mm256_blendv_epi8 (m0, m1, d0);
+	      __m256i s1	= _mm256_blendv_epi8 (m2, m3, d1);
+//	the unpacks work per 128 bit lane, the low halves hold the
+//	new states 32 * k + 0 .. 7 and 32 * k + 16 .. 23
+	      __m256i lo	= _mm256_unpacklo_epi16 (s0, s1);
+	      __m256i hi	= _mm256_unpackhi_epi16 (s0, s1);
+	      nm [2 * k]	= _mm256_permute2x128_si256 (lo, hi, 0x20);
+	      nm [2 * k + 1]	= _mm256_permute2x128_si256 (lo, hi, 0x31);
+	      __m256i dBytes	=
+	             _mm256_packs_epi16 (_mm256_unpacklo_epi16 (d0, d1),
+	                                 _mm256_unpackhi_epi16 (d0, d1));
+	      decisions	|= (uint64_t)(uint32_t)
+	                           _mm256_movemask_epi8 (dBytes) << (32 * k);
+	   }
+	   for (i = 0; i < 4; i ++)
+	      m [i] = nm [i];
+	   d [s]. w [0]	= (uint32_t)decisions;
+	   d [s]. w [1]	= (uint32_t)(decisions >> 32);
+	}
+	for (i = 0; i < 4; i ++)
+	   _mm256_store_si256 ((__m256i *)&start [16 * i], m [i]);
+	for (i = 0; i < NUMSTATES; i ++)
+	   vp -> old_metrics -> t [i] = (uint16_t)start [i];
+}
+//
+//	SSE2: the same, with 8 lanes per register
+void	viterbi_768::update_viterbi_blk_SSE2 (struct v *vp,
+	                                      COMPUTETYPE *syms,
+	                                      int16_t nbits) {
+decision_t *d = (decision_t *)vp -> decisions;
+int16_t	start [NUMSTATES] __attribute__ ((aligned (16)));
+int32_t	s, i, k;
+__m128i	m [8];		// 8 states per register
+__m128i	nm [8];
+const __m128i max	= _mm_set1_epi16 (RATE * 255);
+const __m128i zero	= _mm_setzero_si128 ();
+
+	for (i = 0; i < NUMSTATES; i ++)
+	   start [i] = vp -> old_metrics -> t [i];
+	for (i = 0; i < 8; i ++)
+	   m [i] = _mm_load_si128 ((__m128i *)&start [8 * i]);
+
+	for (s = 0; s < nbits; s ++) {
+	   __m128i sym [RATE];
+	   uint64_t decisions	= 0;
+	   for (i = 0; i < RATE; i ++)
+	      sym [i] = _mm_set1_epi16 (syms [s * RATE + i]);
+
+	   for (k = 0; k < 4; k ++) {	// butterflies 8 * k .. 8 * k + 7
+	      __m128i metric	= zero;
+	      for (i = 0; i < RATE; i ++)
+	         metric = _mm_add_epi16 (metric,
+	                    _mm_xor_si128 (sym [i],
+	                        _mm_load_si128 ((__m128i *)
+	                         &Branchtab16 [i * NUMSTATES / 2 + 8 * k])));
+	      __m128i other	= _mm_sub_epi16 (max, metric);
+	      __m128i m0	= _mm_add_epi16 (m [k], metric);
+	      __m128i m1	= _mm_add_epi16 (m [k + 4], other);
+	      __m128i m2	= _mm_add_epi16 (m [k], other);
+	      __m128i m3	= _mm_add_epi16 (m [k + 4], metric);
+	      __m128i d0	= _mm_cmpgt_epi16 (_mm_sub_epi16 (m0, m1), zero);
+	      __m128i d1	= _mm_cmpgt_epi16 (_mm_sub_epi16 (m2, m3), zero);
+	      __m128i s0	= _mm_or_si128 (_mm_and_si128 (d0, m1),
+	                                        _mm_andnot_si128 (d0, m0));
+	      __m128i s1	= _mm_or_si128 (_mm_and_si128 (d1, m3),
+	                                        _mm_andnot_si128 (d1, m2));
+	      nm [2 * k]	= _mm_unpacklo_epi16 (s0, s1);
+	      nm [2 * k + 1]	= _mm_unpackhi_epi16 (s0, s1);
+	      __m128i dBytes	=
+	             _mm_packs_epi16 (_mm_unpacklo_epi16 (d0, d1),
+	                              _mm_unpackhi_epi16 (d0, d1));
+	      decisions	|= (uint64_t)_mm_movemask_epi8 (dBytes) << (16 * k);
+	   }
+	   for (i = 0; i < 8; i ++)
+	      m [i] = nm [i];
+	   d [s]. w [0]	= (uint32_t)decisions;
+	   d [s]. w [1]	= (uint32_t)(decisions >> 32);
+	}
+	for (i = 0; i < 8; i ++)
+	   _mm_store_si128 ((__m128i *)&start [8 * i], m [i]);
+	for (i = 0; i < NUMSTATES; i ++)
+	   vp -> old_metrics -> t [i] = (uint16_t)start [i];
+}
+#endif
+
 extern "C" {
-#if defined(SSE_AVAILABLE)
-void FULL_SPIRAL_sse (int,
-#elif defined(NEON_AVAILABLE)
+#if defined(NEON_AVAILABLE)
 void FULL_SPIRAL_neon (int,
+#elif defined(__SSE2__)
+void FULL_SPIRAL_sse (int,
 #else
 void FULL_SPIRAL_no_sse (int,
 #endif
@@ -320,15 +787,16 @@ void	viterbi_768::update_viterbi_blk_SPIRAL (struct v *vp,
 decision_t *d = (decision_t *)vp -> decisions;
 int32_t s;
 
-	for (s = 0; s < nbits; s++)
+//	the spiral code does two steps per round
+	for (s = 0; s < 2 * ((nbits + 1) / 2); s++)
 	   memset (d + s, 0, sizeof(decision_t));
 
-#if defined(SSE_AVAILABLE)
-	FULL_SPIRAL_sse (nbits,
-#elif defined(NEON_AVAILABLE)
-	FULL_SPIRAL_neon (nbits,
+#if defined(NEON_AVAILABLE)
+	FULL_SPIRAL_neon ((nbits + 1) / 2,
+#elif defined(__SSE2__)
+	FULL_SPIRAL_sse ((nbits + 1) / 2,
 #else
-	FULL_SPIRAL_no_sse (nbits,
+	FULL_SPIRAL_no_sse ((nbits + 1) / 2,
 #endif
 	                 vp -> new_metrics -> t,
 	                 vp -> old_metrics -> t,
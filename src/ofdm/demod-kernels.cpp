@@ -0,0 +1,333 @@
+#
+/*
+ *    Copyright (C) 2013 .. 2017
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#
+#include	"demod-kernels.h"
+#include	"dab-params.h"
+#include	"cpu-features.h"
+#include	<stdio.h>
+#include	<string.h>
+#if defined (__SSE2__)
+//	the AVX2 variant is compiled in anyway, it is selected
+//	at run time when cpuid says so
+#include	<immintrin.h>
+#define	TARGET_AVX2	__attribute__ ((target ("avx2")))
+#endif
+#define	HALF_PI	1.57079637f
+#define	PI	3.14159274f
+
+//
+//	atan (a) for 0 <= a <= 1, a minimax polynomial
+static inline
+float	atanPoly	(float a) {
+float	s	= a * a;
+	return a * (0.99997726f + s * (-0.33262347f + s * (0.19354346f +
+	            s * (-0.11643287f + s * (0.05265332f +
+	            s * (-0.01172120f))))));
+}
+
+float	fastArg		(std::complex<float> v) {
+float	x	= real (v);
+float	y	= imag (v);
+float	ax	= x < 0 ? -x : x;
+float	ay	= y < 0 ? -y : y;
+float	r;
+	if ((ax == 0) && (ay == 0))
+	   return 0;
+	r	= ay > ax ? HALF_PI - atanPoly (ax / ay) : atanPoly (ay / ax);
+	if (x < 0)
+	   r	= PI - r;
+	return y < 0 ? -r : r;
+}
+
+static inline
+void	scalarPhaseDiffs (const std::complex<float> *x,
+	                  float *d, int32_t n, int32_t first) {
+int32_t	i;
+	for (i = first; i < n; i ++) {
+	   float r	= fastArg (x [i] * conj (x [i + 1]));
+	   d [i]	= r < 0 ? -r : r;
+	}
+}
+
+//
+//	The division is done in float and the scaling in double,
+//	as the original code did, since that keeps the
+//	results of the variants bit identical. An approximate
+//	reciprocal would save little, the gathering of the carriers
+//	takes most of the time
+static inline
+void	scalarDemod	(const std::complex<float> *v,
+	                 const std::complex<float> *ref,
+	                 const int32_t *bins,
+	                 int8_t *ibits, int32_t carriers,
+	                 int32_t first) {
+int32_t	i;
+	for (i = first; i < carriers; i ++) {
+	   const std::complex<float> a	= v [bins [i]];
+	   const std::complex<float> b	= ref [bins [i]];
+	   float re	= real (a) * real (b) + imag (a) * imag (b);
+	   float im	= imag (a) * real (b) - real (a) * imag (b);
+	   float ab	= (re < 0 ? -re : re) + (im < 0 ? -im : im);
+	   ibits [i]		= (-re / ab) * 127.0;
+	   ibits [carriers + i]	= (-im / ab) * 127.0;
+	}
+}
+
+#if defined (__SSE2__)
+//
+//	four floats, scaled in double, truncated to int32
+TARGET_AVX2 static inline
+__m128i	toSoft4	(__m128 q) {
+	return _mm256_cvttpd_epi32 (_mm256_mul_pd (_mm256_cvtps_pd (q),
+	                                        _mm256_set1_pd (127.0)));
+}
+
+template <int32_t K>
+TARGET_AVX2 static
+void	demodAVX2	(const std::complex<float> *v,
+	                 const std::complex<float> *ref,
+	                 const int32_t *bins,
+	                 int8_t *ibits, int32_t carriers) {
+const int32_t	LANES	= 8;
+const int32_t	n	= K > 0 ? K : carriers;
+int32_t	groups	= n / LANES;
+int32_t	i;
+const double *dv	= (const double *)v;
+const double *dr	= (const double *)ref;
+__m256	absMask	= _mm256_castsi256_ps (_mm256_set1_epi32 (0x7FFFFFFF));
+__m256	signBit	= _mm256_castsi256_ps (_mm256_set1_epi32 (0x80000000));
+//
+//	gathering carriers 0 1 4 5 and 2 3 6 7 gives - after the
+//	shuffles below - the real and imaginary parts in order
+__m256i	order	= _mm256_setr_epi32 (0, 1, 4, 5, 2, 3, 6, 7);
+//	the masked gathers, with a defined source, since the plain
+//	ones leave the compiler with an uninitialized operand
+const __m256d	zero	= _mm256_setzero_pd ();
+const __m256d	all	= _mm256_castsi256_pd (_mm256_set1_epi64x (-1));
+
+	for (i = 0; i < groups; i ++) {
+	   __m256i idx	= _mm256_permutevar8x32_epi32 (
+	                     _mm256_loadu_si256 ((const __m256i *)&bins [LANES * i]),
+	                     order);
+	   __m128i i0	= _mm256_castsi256_si128 (idx);
+	   __m128i i1	= _mm256_extracti128_si256 (idx, 1);
+	   __m256 a0	= _mm256_castpd_ps (_mm256_mask_i32gather_pd (zero,
+	                                          dv, i0, all, 8));
+	   __m256 a1	= _mm256_castpd_ps (_mm256_mask_i32gather_pd (zero,
+	                                          dv, i1, all, 8));
+	   __m256 b0	= _mm256_castpd_ps (_mm256_mask_i32gather_pd (zero,
+	                                          dr, i0, all, 8));
+	   __m256 b1	= _mm256_castpd_ps (_mm256_mask_i32gather_pd (zero,
+	                                          dr, i1, all, 8));
+	   __m256 ar	= _mm256_shuffle_ps (a0, a1, _MM_SHUFFLE (2, 0, 2, 0));
+	   __m256 ai	= _mm256_shuffle_ps (a0, a1, _MM_SHUFFLE (3, 1, 3, 1));
+	   __m256 br	= _mm256_shuffle_ps (b0, b1, _MM_SHUFFLE (2, 0, 2, 0));
+	   __m256 bi	= _mm256_shuffle_ps (b0, b1, _MM_SHUFFLE (3, 1, 3, 1));
+//	no fused multiply add here, that would change the rounding
+	   __m256 re	= _mm256_add_ps (_mm256_mul_ps (ar, br),
+	                                 _mm256_mul_ps (ai, bi));
+	   __m256 im	= _mm256_sub_ps (_mm256_mul_ps (ai, br),
+	                                 _mm256_mul_ps (ar, bi));
+	   __m256 ab	= _mm256_add_ps (_mm256_and_ps (re, absMask),
+	                                 _mm256_and_ps (im, absMask));
+	   __m256 qr	= _mm256_div_ps (_mm256_xor_ps (re, signBit), ab);
+	   __m256 qi	= _mm256_div_ps (_mm256_xor_ps (im, signBit), ab);
+	   __m128i sr	= _mm_packs_epi32 (
+	                        toSoft4 (_mm256_castps256_ps128 (qr)),
+	                        toSoft4 (_mm256_extractf128_ps (qr, 1)));
+	   __m128i si	= _mm_packs_epi32 (
+	                        toSoft4 (_mm256_castps256_ps128 (qi)),
+	                        toSoft4 (_mm256_extractf128_ps (qi, 1)));
+	   _mm_storel_epi64 ((__m128i *)&ibits [LANES * i],
+	                                      _mm_packs_epi16 (sr, sr));
+	   _mm_storel_epi64 ((__m128i *)&ibits [n + LANES * i],
+	                                      _mm_packs_epi16 (si, si));
+	}
+	scalarDemod (v, ref, bins, ibits, n, groups * LANES);
+}
+//
+//	two floats, scaled in double, truncated to int32
+static inline
+__m128i	toSoft	(__m128 q) {
+	return _mm_cvttpd_epi32 (_mm_mul_pd (_mm_cvtps_pd (q),
+	                                     _mm_set1_pd (127.0)));
+}
+
+static inline
+__m128	load2	(const std::complex<float> *x, int32_t k0, int32_t k1) {
+	return _mm_castpd_ps (_mm_loadh_pd (_mm_load_sd ((const double *)&x [k0]),
+	                                    (const double *)&x [k1]));
+}
+
+template <int32_t K>
+static
+void	demodSSE2	(const std::complex<float> *v,
+	                 const std::complex<float> *ref,
+	                 const int32_t *bins,
+	                 int8_t *ibits, int32_t carriers) {
+const int32_t	LANES	= 4;
+const int32_t	n	= K > 0 ? K : carriers;
+int32_t	groups	= n / LANES;
+int32_t	i;
+__m128	absMask	= _mm_castsi128_ps (_mm_set1_epi32 (0x7FFFFFFF));
+__m128	signBit	= _mm_castsi128_ps (_mm_set1_epi32 (0x80000000));
+
+	for (i = 0; i < groups; i ++) {
+	   const int32_t *k	= &bins [LANES * i];
+	   __m128 a0	= load2 (v, k [0], k [1]);
+	   __m128 a1	= load2 (v, k [2], k [3]);
+	   __m128 b0	= load2 (ref, k [0], k [1]);
+	   __m128 b1	= load2 (ref, k [2], k [3]);
+	   __m128 ar	= _mm_shuffle_ps (a0, a1, _MM_SHUFFLE (2, 0, 2, 0));
+	   __m128 ai	= _mm_shuffle_ps (a0, a1, _MM_SHUFFLE (3, 1, 3, 1));
+	   __m128 br	= _mm_shuffle_ps (b0, b1, _MM_SHUFFLE (2, 0, 2, 0));
+	   __m128 bi	= _mm_shuffle_ps (b0, b1, _MM_SHUFFLE (3, 1, 3, 1));
+	   __m128 re	= _mm_add_ps (_mm_mul_ps (ar, br), _mm_mul_ps (ai, bi));
+	   __m128 im	= _mm_sub_ps (_mm_mul_ps (ai, br), _mm_mul_ps (ar, bi));
+	   __m128 ab	= _mm_add_ps (_mm_and_ps (re, absMask),
+	                              _mm_and_ps (im, absMask));
+	   __m128 qr	= _mm_div_ps (_mm_xor_ps (re, signBit), ab);
+	   __m128 qi	= _mm_div_ps (_mm_xor_ps (im, signBit), ab);
+	   __m128i sr	= _mm_unpacklo_epi64 (toSoft (qr),
+	                                      toSoft (_mm_movehl_ps (qr, qr)));
+	   __m128i si	= _mm_unpacklo_epi64 (toSoft (qi),
+	                                      toSoft (_mm_movehl_ps (qi, qi)));
+	   sr		= _mm_packs_epi32 (sr, sr);
+	   si		= _mm_packs_epi32 (si, si);
+	   int32_t r4	= _mm_cvtsi128_si32 (_mm_packs_epi16 (sr, sr));
+	   int32_t i4	= _mm_cvtsi128_si32 (_mm_packs_epi16 (si, si));
+	   memcpy (&ibits [LANES * i], &r4, LANES);
+	   memcpy (&ibits [n + LANES * i], &i4, LANES);
+	}
+	scalarDemod (v, ref, bins, ibits, n, groups * LANES);
+}
+//
+//	the variant for a number of carriers
+template <int32_t K>
+static
+demodulator	demodBody	(void) {
+	if (cpu_hasAVX2 ())
+	   return demodAVX2 <K>;
+	return demodSSE2 <K>;
+}
+#define	KERNEL_NAME	(cpu_hasAVX2 () ? "avx2" : "sse2")
+#else
+template <int32_t K>
+static
+void	demodScalar	(const std::complex<float> *v,
+	                 const std::complex<float> *ref,
+	                 const int32_t *bins,
+	                 int8_t *ibits, int32_t carriers) {
+	scalarDemod (v, ref, bins, ibits, K > 0 ? K : carriers, 0);
+}
+
+template <int32_t K>
+static
+demodulator	demodBody	(void) {
+	return demodScalar <K>;
+}
+#define	KERNEL_NAME	"scalar"
+#endif
+
+void	demodulate	(const std::complex<float> *v,
+	                 const std::complex<float> *ref,
+	                 const int32_t *bins,
+	                 int8_t *ibits, int32_t carriers) {
+static const demodulator general	= demodBody <0> ();
+	general (v, ref, bins, ibits, carriers);
+}
+
+//
+//	With the number of carriers known at compile time the loops
+//	have a fixed trip count, and - all numbers of carriers being
+//	a multiple of 8 - the scalar tail disappears
+demodulator	demodulatorFor	(uint8_t dabMode) {
+	fprintf (stderr, "demodulator: %s kernel\n", KERNEL_NAME);
+	switch (dabMode) {
+	   case 1:
+	      return demodBody <modeConstants <1>::K> ();
+	   case 2:
+	      return demodBody <modeConstants <2>::K> ();
+	   case 4:
+	      return demodBody <modeConstants <4>::K> ();
+	   default:
+	      return demodulate;
+	}
+}
+//
+//	the phase differences are only needed for some 110 carriers
+//	per frame, four lanes will do
+#if defined (__SSE2__)
+void	absPhaseDiffs	(const std::complex<float> *x,
+	                 float *d, int32_t n) {
+int32_t	groups	= n / 4;
+int32_t	i;
+const float *fx	= (const float *)x;
+__m128	absMask	= _mm_castsi128_ps (_mm_set1_epi32 (0x7FFFFFFF));
+
+	for (i = 0; i < groups; i ++) {
+	   __m128 a0	= _mm_loadu_ps (&fx [8 * i]);
+	   __m128 a1	= _mm_loadu_ps (&fx [8 * i + 4]);
+	   __m128 b0	= _mm_loadu_ps (&fx [8 * i + 2]);
+	   __m128 b1	= _mm_loadu_ps (&fx [8 * i + 6]);
+	   __m128 ar	= _mm_shuffle_ps (a0, a1, _MM_SHUFFLE (2, 0, 2, 0));
+	   __m128 ai	= _mm_shuffle_ps (a0, a1, _MM_SHUFFLE (3, 1, 3, 1));
+	   __m128 br	= _mm_shuffle_ps (b0, b1, _MM_SHUFFLE (2, 0, 2, 0));
+	   __m128 bi	= _mm_shuffle_ps (b0, b1, _MM_SHUFFLE (3, 1, 3, 1));
+//	x [i] * conj (x [i + 1])
+	   __m128 re	= _mm_add_ps (_mm_mul_ps (ar, br), _mm_mul_ps (ai, bi));
+	   __m128 im	= _mm_sub_ps (_mm_mul_ps (ai, br), _mm_mul_ps (ar, bi));
+	   __m128 ax	= _mm_and_ps (re, absMask);
+	   __m128 ay	= _mm_and_ps (im, absMask);
+	   __m128 mx	= _mm_max_ps (ax, ay);
+	   __m128 mn	= _mm_min_ps (ax, ay);
+//	0 / 0 gives a NaN, which is masked away
+	   __m128 q	= _mm_and_ps (_mm_div_ps (mn, mx),
+	                              _mm_cmpgt_ps (mx, _mm_setzero_ps ()));
+	   __m128 s	= _mm_mul_ps (q, q);
+	   __m128 p	= _mm_set1_ps (-0.01172120f);
+	   p	= _mm_add_ps (_mm_mul_ps (p, s), _mm_set1_ps (0.05265332f));
+	   p	= _mm_add_ps (_mm_mul_ps (p, s), _mm_set1_ps (-0.11643287f));
+	   p	= _mm_add_ps (_mm_mul_ps (p, s), _mm_set1_ps (0.19354346f));
+	   p	= _mm_add_ps (_mm_mul_ps (p, s), _mm_set1_ps (-0.33262347f));
+	   p	= _mm_add_ps (_mm_mul_ps (p, s), _mm_set1_ps (0.99997726f));
+	   p	= _mm_mul_ps (p, q);
+//	if |im| > |re| the angle is pi / 2 - p, if re < 0 it is pi - that
+	   __m128 swap	= _mm_cmpgt_ps (ay, ax);
+	   p	= _mm_or_ps (_mm_and_ps (swap,
+	                                 _mm_sub_ps (_mm_set1_ps (HALF_PI), p)),
+	                     _mm_andnot_ps (swap, p));
+	   __m128 neg	= _mm_cmplt_ps (re, _mm_setzero_ps ());
+	   p	= _mm_or_ps (_mm_and_ps (neg,
+	                                 _mm_sub_ps (_mm_set1_ps (PI), p)),
+	                     _mm_andnot_ps (neg, p));
+	   _mm_storeu_ps (&d [4 * i], p);
+	}
+	scalarPhaseDiffs (x, d, n, 4 * groups);
+}
+#else
+void	absPhaseDiffs	(const std::complex<float> *x,
+	                 float *d, int32_t n) {
+	scalarPhaseDiffs (x, d, n, 0);
+}
+#endif
+
@@ -32,6 +32,42 @@
 #include	"msc-handler.h"
 #include	"freq-interleaver.h"
 #include	"dab-params.h"
+#include	"demod-kernels.h"
+#ifdef	__THREADED_DECODING
+#include	<chrono>
+
+static inline
+int64_t	getMyTime	(void) {
+	return std::chrono::duration_cast <std::chrono::nanoseconds>
+	          (std::chrono::steady_clock::now (). time_since_epoch ()).
+	                                                          count ();
+}
+//
+//	An fftWorker does nothing but claiming symbols and doing
+//	their FFT. The FFTs of the symbols are independent, so
+//	any number of workers can do them in parallel
+class	fftWorker: public QThread {
+public:
+		fftWorker	(ofdmDecoder *d) {
+	   this	-> theDecoder	= d;
+	}
+		~fftWorker	(void) {}
+private:
+	ofdmDecoder	*theDecoder;
+	void	run	(void) {
+	   while (theDecoder -> running. load ()) {
+	      if (theDecoder -> transformNext ())
+	         continue;
+	      theDecoder -> workEvent. prepareWait ();
+	      if (theDecoder -> claimed. load () <
+	                             theDecoder -> produced. load ())
+	         theDecoder -> workEvent. cancelWait ();
+	      else
+	         theDecoder -> workEvent. wait (100);
+	   }
+	}
+};
+#endif
 
 /**
   *	\brief ofdmDecoder
@@ -39,8 +75,9 @@
   *	taking the data from the ofdmProcessor class in, and
   *	will extract the Tu samples, do an FFT and extract the
   *	carriers and map them on (soft) bits
-  *	In the threaded version, a thread will run, fetch the
-  *	data blocks asynchronously and do all computations.
+  *	In the threaded version, a pool of workers does the FFTs,
+  *	and the thread of the decoder itself does the differential
+  *	demodulation, in order, and passes the bits on.
   *	Threading is needed for e.g. the RPI 2 version
   *	In the non-threaded version, the functions in the class
   *	are just executed in the caller's thread
@@ -52,9 +89,6 @@
 	                                 mscHandler	*my_mscHandler):
 	                                    params (dabMode),
 	                                    my_fftHandler (dabMode),
-#ifdef	__THREADED_DECODING
-	                                    bufferSpace (params. get_L ()),
-#endif
 	                                    myMapper (dabMode) {
 int16_t	i;
 	this	-> myRadioInterface	= mr;
@@ -68,276 +102,435 @@ int16_t	i;
 	ibits. resize (2 * this -> carriers);
 
 	this	-> T_g			= T_s - T_u;
-	fft_buffer			= my_fftHandler. getVector ();
-	phaseReference			.resize (T_u);
+//
+//	a little optimization: we do not interchange the
+//	positive/negative frequencies to their right positions.
+//	The de-interleaving understands this.
+//	Note that "mapIn" maps to -carriers / 2 .. carriers / 2
+	binTable. resize (carriers);
+	for (i = 0; i < carriers; i ++) {
+	   int16_t	index	= myMapper.  mapIn (i);
+	   if (index < 0) 
+	      index += T_u;
+	   binTable [i]	= index;
+	}
+	demodulateBlock		= demodulatorFor (params. get_dabMode ());
+	ficFrame		= true;
 
 	snrCount		= 0;
 	snr			= 0;	
 
 #ifdef __THREADED_DECODING
 /**
-  *	When implemented in a thread, the thread controls the
-  *	reading in of the data and processing the data through
-  *	functions for handling block 0, FIC blocks and MSC blocks.
-  *
-  *	We just create a large buffer where index i refers to block i.
-  *
+  *	When implemented in a thread, the symbols are copied into
+  *	a ring of slots, large enough to hold a frame.
+  *	The slots are allocated through fftw, so that the FFT
+  *	can be done in place in the slot.
+  *	We leave two cores for the dabProcessor and the decoder thread,
+  *	the latter will do FFTs as well when it has nothing else to do.
   */
-	command			= new std::complex<float> * [nrBlocks];
-	for (i = 0; i < nrBlocks; i ++)
-	   command [i] = new std::complex<float> [T_u];
-	amount		= 0;
+	nrWorkers		= QThread::idealThreadCount () - 2;
+	if (nrWorkers < 1)
+	   nrWorkers = 1;
+	if (nrWorkers > 3)
+	   nrWorkers = 3;
+	nrSlots			= nrBlocks;
+	slot			= new std::complex<float> * [nrSlots];
+	slotBlock		= new int32_t [nrSlots];
+	slotUse			= new uint8_t [nrSlots];
+	slotDone		= new std::atomic<int32_t> [nrSlots];
+	for (i = 0; i < nrSlots; i ++) {
+	   slot [i] = (std::complex<float> *)
+	          FFTW_MALLOC (sizeof (std::complex<float>) * T_u);
+	   slotBlock [i] = 0;
+	   slotUse [i]	= BLOCK_SKIPPED;
+	   slotDone [i]. store (0);
+	}
+	for (i = 0; i < nrWorkers; i ++)
+	   workers. push_back (new fftWorker (this));
+	running. store (false);
+	inputBuffer. resize (T_s);
+#else
+/**
+  *	Without threading, the symbols of the frame are collected
+  *	and transformed in two batches: when block 3 is in, the
+  *	FIC blocks (with block 0 as first reference) are done, the
+  *	MSC blocks are done at the end of the frame. The carriers
+  *	of the frame remain available, so the carriers of a
+  *	block are the phase reference for the next block as they are
+  */
+	frameBuffer	= (std::complex<float> *)
+	          FFTW_MALLOC (sizeof (std::complex<float>) * nrBlocks * T_s);
+	carrierBuffer	= (std::complex<float> *)
+	          FFTW_MALLOC (sizeof (std::complex<float>) * nrBlocks * T_u);
+	ficBatch	= new fftBatch (dabMode, 4,
+	                                &frameBuffer [T_g], T_s,
+	                                carrierBuffer);
+	mscBatch	= new fftBatch (dabMode, nrBlocks - 4,
+	                                &frameBuffer [4 * T_s + T_g], T_s,
+	                                &carrierBuffer [4 * T_u]);
+	frameUse. resize (nrBlocks);
 #endif
 }
 
 	ofdmDecoder::~ofdmDecoder	(void) {
-int16_t	i;
 #ifdef	__THREADED_DECODING
-	running. store (false);
-	while (isRunning ()) {
-	   commandHandler. wakeAll ();
-	   usleep (1000);
-	}
-	for (i = 0; i < nrBlocks; i ++)
-	   delete[] command [i];
-	delete[]	command;
+int16_t	i;
+	stop ();
+	for (i = 0; i < nrWorkers; i ++)
+	   delete workers [i];
+	for (i = 0; i < nrSlots; i ++)
+	   FFTW_FREE (slot [i]);
+	delete[]	slot;
+	delete[]	slotBlock;
+	delete[]	slotUse;
+	delete[]	slotDone;
+#else
+	delete	ficBatch;
+	delete	mscBatch;
+	FFTW_FREE (frameBuffer);
+	FFTW_FREE (carrierBuffer);
 #endif
-
 }
 //
 //	the client of this class should not know whether
 //	we run with a separate thread or not,
-#ifndef	__THREADED_DECODING
 void	ofdmDecoder::start	(void) {
-}
+#ifdef	__THREADED_DECODING
+int16_t	i;
+	if (running. load ())
+	   return;
+	produced. store (0);
+	claimed. store (0);
+	released. store (0);
+	for (i = 0; i < nrSlots; i ++)
+	   slotDone [i]. store (0);
+	fftTime. store (0);
+	copyTime. store (0);
+	demodTime	= 0;
+	waitTime	= 0;
+	symbolCount	= 0;
+	running. store (true);
+	for (i = 0; i < nrWorkers; i ++)
+	   workers [i] -> start ();
+	QThread::start ();
 #endif
+}
 
 void	ofdmDecoder::stop	(void) {
 #ifdef	__THREADED_DECODING
+int16_t	i;
 	running. store (false);
-	while (isRunning ()) {
-	   commandHandler. wakeAll ();
-	   usleep (1000);
-	}
+	spaceEvent.	notifyAll ();
+	workEvent.	notifyAll ();
+	doneEvent.	notifyAll ();
+	for (i = 0; i < nrWorkers; i ++)
+	   workers [i] -> wait ();
+	QThread::wait ();
 #endif
 }
 
 void	ofdmDecoder::reset	(void) {
 #ifdef	__THREADED_DECODING
 	stop  ();
-	usleep (10000);
 	start ();
 #endif
 }
 
 //
+//	Blocks 1 .. 3 are FIC blocks, decoded when the ficHandler
+//	wants the FIC of the frame, which is asked - once per
+//	frame - for block 0. Block 0 and block 3 are (also)
+//	reference blocks.
+//	An MSC block is decoded when a backend needs it, and
+//	transformed as reference when the next block is needed
+uint8_t	ofdmDecoder::blockUse	(int32_t blkno) {
+	if (blkno == 0) {
+	   ficFrame	= my_ficHandler -> frameNeeded ();
+	   return ficFrame ? BLOCK_REFERENCE : BLOCK_SKIPPED;
+	}
+	if (blkno < 4) {
+	   if (ficFrame)
+	      return BLOCK_DATA;
+	   if ((blkno == 3) && my_mscHandler -> blockNeeded (4))
+	      return BLOCK_REFERENCE;
+	   return BLOCK_SKIPPED;
+	}
+	if (my_mscHandler -> blockNeeded (blkno))
+	   return BLOCK_DATA;
+	if ((blkno + 1 < nrBlocks) && my_mscHandler -> blockNeeded (blkno + 1))
+	   return BLOCK_REFERENCE;
+	return BLOCK_SKIPPED;
+}
 
 #ifdef	__THREADED_DECODING
 /**
-  *	The code in the thread executes a simple loop,
-  *	waiting for the next block and executing the interpretation
-  *	operation for that block.
-  *	In our original code the block count was 1 higher than
-  *	our count here.
+  *	The producer side: the dabProcessor thread copies the T_u
+  *	samples of the symbol into the next free slot, and tells
+  *	the workers. The hand over itself is lock free, the
+  *	eventCounts are only used when a thread has to sleep.
   */
-void	ofdmDecoder::run	(void) {
-int16_t	currentBlock	= 0;
+void	ofdmDecoder::enterBlock	(std::complex<float> *v, int32_t blkno) {
+int64_t	seq	= produced. load ();
+int64_t	t0	= getMyTime ();
+int32_t	s;
 
-	running. store (true);
-	while (running. load ()) {
-	   helper. lock ();
-	   commandHandler. wait (&helper, 100);
-	   helper. unlock ();
-	   while ((amount > 0) && running. load ()) {
-	      if (currentBlock == 0)
-	         processBlock_0 ();
-	      else
-	      if (currentBlock < 4)
-	         decodeFICblock (currentBlock);
-	      else
-	         decodeMscblock (currentBlock);
-	      bufferSpace. release (1);
-	      helper. lock ();
-	      currentBlock = (currentBlock + 1) % (nrBlocks);
-	      amount -= 1;
-	      helper. unlock ();
-	   }
+	while (seq - released. load () >= nrSlots) {
+	   if (!running. load ())
+	      return;
+	   spaceEvent. prepareWait ();
+	   if (seq - released. load () < nrSlots)
+	      spaceEvent. cancelWait ();
+	   else
+	      spaceEvent. wait (100);
 	}
-	fprintf (stderr, "ofdm decoder is closing down now\n");
+
+	s	= seq % nrSlots;
+	slotUse [s]	= blockUse (blkno);
+	if (slotUse [s] != BLOCK_SKIPPED)
+	   memcpy (slot [s], v, T_u * sizeof (std::complex<float>));
+	slotBlock [s]	= blkno;
+	produced. store (seq + 1);
+	workEvent. notify ();
+	copyTime. fetch_add (getMyTime () - t0);
 }
-/**
-  *	We need some functions to enter the ofdmProcessor data
-  *	in the buffer.
-  */
-void	ofdmDecoder::processBlock_0 (std::vector<std::complex<float>>vi) {
-	bufferSpace. acquire (1);
-	memcpy (command [0], vi. data (), sizeof (std::complex<float>) * T_u);
-	helper. lock ();
-	amount ++;
-	commandHandler. wakeOne ();
-	helper. unlock ();
+
+//
+//	the symbols are copied into the slots anyway, so one buffer
+//	will do
+std::complex<float>	*ofdmDecoder::blockBuffer	(int32_t blkno) {
+	(void)blkno;
+	return inputBuffer. data ();
+}
+
+void	ofdmDecoder::processBlock_0 (std::complex<float> *vi) {
+	enterBlock (vi, 0);
 }
 
-void	ofdmDecoder::decodeFICblock (std::vector<std::complex<float>> vi,
+void	ofdmDecoder::decodeFICblock (std::complex<float> *vi,
 		                                             int32_t blkno) {
-	bufferSpace. acquire (1);
-	memcpy (command [blkno], &((vi. data ()) [T_g]),
-	                                  sizeof (std::complex<float>) * T_u);
-	helper. lock ();
-	amount ++;
-	commandHandler. wakeOne ();
-	helper. unlock ();
+	enterBlock (&vi [T_g], blkno);
 }
 
-void	ofdmDecoder::decodeMscblock (std::vector<std::complex<float> > vi,
+void	ofdmDecoder::decodeMscblock (std::complex<float> *vi,
 	                                                     int32_t blkno) {
-	bufferSpace. acquire (1);
-	memcpy (command [blkno], &((vi. data ()) [T_g]),
-	                                   sizeof (std::complex<float>) * T_u);
-	helper. lock ();
-	amount ++;
-	commandHandler. wakeOne ();
-	helper. unlock ();
+	enterBlock (&vi [T_g], blkno);
 }
-#endif
-/**
-  *	Note that the distinction, made in the ofdmProcessor class
-  *	does not add much here, iff we decide to choose the multi core
-  *	option definitely, then code may be simplified there.
-  */
+//
+//	claim the oldest symbol not yet claimed and do its FFT.
+//	Called by the workers and by the decoder thread
+bool	ofdmDecoder::transformNext	(void) {
+int64_t	c	= claimed. load ();
 
+	while (c < produced. load ()) {
+	   if (claimed. compare_exchange_weak (c, c + 1)) {
+	      int64_t t0	= getMyTime ();
+	      int32_t s		= c % nrSlots;
+	      if (slotUse [s] != BLOCK_SKIPPED)
+	         my_fftHandler. do_FFT (slot [s]);
+	      slotDone [s]. store (1);
+	      fftTime. fetch_add (getMyTime () - t0);
+	      doneEvent. notify ();
+	      return true;
+	   }
+	}
+	return false;
+}
 /**
-  *	handle block 0 as collected from the buffer
+  *	The decoder thread takes the transformed symbols in order.
+  *	The carriers of a symbol are the phase reference for the
+  *	next one, so a slot is freed only after the next symbol
+  *	is demodulated.
   */
-#ifdef	__THREADED_DECODING
-void	ofdmDecoder::processBlock_0 (void) {
+void	ofdmDecoder::run	(void) {
+int64_t	consumed	= 0;
+int32_t	previous	= -1;
 
-	memcpy (fft_buffer, command [0], T_u * sizeof (std::complex<float>));
-#else
-void	ofdmDecoder::processBlock_0 (std::vector <std::complex<float> > buffer) {
-	memcpy (fft_buffer, buffer. data (),
-	                             T_u * sizeof (std::complex<float>));
-#endif
+	while (running. load ()) {
+	   int32_t s	= consumed % nrSlots;
+	   if (slotDone [s]. load () == 0) {
+	      if (transformNext ())
+	         continue;
+	      int64_t t0	= getMyTime ();
+	      doneEvent. prepareWait ();
+	      if (slotDone [s]. load () != 0)
+	         doneEvent. cancelWait ();
+	      else
+	         doneEvent. wait (100);
+	      waitTime	+= getMyTime () - t0;
+	      continue;
+	   }
 
-	my_fftHandler. do_FFT ();
-/**
-  *	The SNR is determined by looking at a segment of bins
-  *	within the signal region and bits outside.
-  *	It is just an indication
-  */
+	   int64_t t0	= getMyTime ();
+	   if ((slotBlock [s] != 0) && (previous >= 0)) {
+	      if ((slotUse [s] == BLOCK_DATA) &&
+	                        (slotUse [previous] != BLOCK_SKIPPED)) {
+	         toBits (slot [s], slot [previous]);
+	         handleBits (slotBlock [s]);
+	      }
+	      else
+	      if (slotBlock [s] >= 4)
+	         my_mscHandler -> process_mscBlock (NULL, slotBlock [s]);
+	      else
+	         my_ficHandler -> process_ficBlock (NULL, slotBlock [s]);
+	   }
+	   demodTime	+= getMyTime () - t0;
+
+	   if (previous >= 0) {
+	      slotDone [previous]. store (0);
+	      released. store (consumed);
+	      spaceEvent. notify ();
+	   }
+	   previous	= s;
+	   consumed ++;
+	   if (++symbolCount >= 10 * nrBlocks)
+	      reportTimings ();
+	}
+	fprintf (stderr, "ofdm decoder is closing down now\n");
+}
+
+void	ofdmDecoder::handleBits	(int32_t blkno) {
+	if (blkno < 4)
+	   my_ficHandler -> process_ficBlock (ibits. data (), blkno);
+	else
+	   my_mscHandler -> process_mscBlock (ibits. data (), blkno);
+}
 
+void	ofdmDecoder::reportTimings	(void) {
+#ifdef	__DECODER_TIMINGS
+	fprintf (stderr,
+	         "ofdmDecoder (%d workers) per symbol: copy %.1f, fft %.1f, demod %.1f, idle %.1f usec\n",
+	         nrWorkers,
+	         copyTime. load () / 1000.0 / symbolCount,
+	         fftTime. load () / 1000.0 / symbolCount,
+	         demodTime / 1000.0 / symbolCount,
+	         waitTime / 1000.0 / symbolCount);
+#endif
+	copyTime. store (0);
+	fftTime. store (0);
+	demodTime	= 0;
+	waitTime	= 0;
+	symbolCount	= 0;
+}
+#else
+//
+//	Block i of the frame is read in frameBuffer [i * T_s],
+//	if the caller uses this buffer, nothing has to be copied
+std::complex<float>	*ofdmDecoder::blockBuffer	(int32_t blkno) {
+	return &frameBuffer [blkno * T_s];
+}
+
+void	ofdmDecoder::enterBlock	(std::complex<float> *v, int32_t blkno) {
+	if (v != &frameBuffer [blkno * T_s])
+	   memcpy (&frameBuffer [blkno * T_s], v,
+	                           T_s * sizeof (std::complex<float>));
+}
 /**
-  *	we are now in the frequency domain, and we keep the carriers
-  *	as coming from the FFT as phase reference.
+  *	handle block 0 as collected from the buffer,
+  *	here only the T_u samples of the symbol itself are given
   */
-	memcpy (phaseReference. data (), fft_buffer,
-	                   T_u * sizeof (std::complex<float>));
+void	ofdmDecoder::processBlock_0 (std::complex<float> *buffer) {
+	memcpy (&frameBuffer [T_g], buffer,
+	                             T_u * sizeof (std::complex<float>));
 }
 //
 /**
   *	for the other blocks of data, the first step is to go from
   *	time to frequency domain, to get the carriers.
-  *	we distinguish between FIC blocks and other blocks,
-  *	only to spare a test. The mapping code is the same
+  *	That is done here for a group of blocks at the time,
+  *	when the last block of the group is in.
+  *	The carriers of block i - 1 are the phase reference
+  *	for block i.
   */
-static
-int	cnt	= 0;
-#ifdef	__THREADED_DECODING
-void	ofdmDecoder::decodeFICblock (int32_t blkno) {
-int16_t	i;
-	memcpy (fft_buffer, command [blkno], T_u * sizeof (std::complex<float>));
-#else
-void	ofdmDecoder::decodeFICblock (std::vector <std::complex<float>> buffer,
+void	ofdmDecoder::decodeFICblock (std::complex<float> *buffer,
 	                                                int32_t blkno) {
-int16_t	i;
-	memcpy (fft_buffer, &((buffer. data ()) [T_g]),
+int32_t	i;
+	enterBlock (buffer, blkno);
+	if (blkno != 3)
+	   return;
+	for (i = 0; i < 4; i ++)
+	   frameUse [i]	= blockUse (i);
+	if (frameUse [1] == BLOCK_DATA) {
+	   ficBatch	-> do_FFT ();
+	   for (i = 1; i < 4; i ++) {
+	      toBits (&carrierBuffer [i * T_u],
+	                             &carrierBuffer [(i - 1) * T_u]);
+	      my_ficHandler -> process_ficBlock (ibits. data (), i);
+	   }
+	   return;
+	}
+//	FIC not needed this frame, block 3 may still be the reference
+	if (frameUse [3] == BLOCK_REFERENCE) {
+	   memcpy (&carrierBuffer [3 * T_u], &frameBuffer [3 * T_s + T_g],
 	                               T_u * sizeof (std::complex<float>));
-#endif
-
-
-fftlabel:
-/**
-  *	first step: do the FFT
-  */
-	my_fftHandler. do_FFT ();
-/**
-  *	a little optimization: we do not interchange the
-  *	positive/negative frequencies to their right positions.
-  *	The de-interleaving understands this
-  */
-toBitsLabel:
-/**
-  *	Note that from here on, we are only interested in the
-  *	"carriers" useful carriers of the FFT output
-  */
-
-	for (i = 0; i < carriers; i ++) {
-	   int16_t	index	= myMapper.  mapIn (i);
-	   if (index < 0) 
-	      index += T_u;
-/**
-  *	decoding is computing the phase difference between
-  *	carriers with the same index in subsequent blocks.
-  *	The carrier of a block is the reference for the carrier
-  *	on the same position in the next block
-  */
-	   std::complex<float>	r1 = fft_buffer [index] *
-	                                    conj (phaseReference [index]);
-	   float ab1	= jan_abs (r1);
-//	split the real and the imaginary part and scale it
-//	we make the bits into softbits in the range -127 .. 127
-	   ibits [i]		=  - real (r1) / ab1 * 127.0;
-	   ibits [carriers + i] =  - imag (r1) / ab1 * 127.0;
+	   my_fftHandler. do_FFT (&carrierBuffer [3 * T_u]);
 	}
-	memcpy (phaseReference. data (), fft_buffer,
-	                            T_u * sizeof (std::complex<float>));
-
-handlerLabel:
-	my_ficHandler -> process_ficBlock (ibits, blkno);
+	for (i = 1; i < 4; i ++)
+	   my_ficHandler -> process_ficBlock (NULL, i);
 }
 /**
   *	Msc block decoding is equal to FIC block decoding,
   *	further processing is different though
   */
-#ifdef	__THREADED_DECODING
-void	ofdmDecoder::decodeMscblock (int32_t blkno) {
-int16_t	i;
-
-	memcpy (fft_buffer, command [blkno], T_u * sizeof (std::complex<float>));
-#else
-void	ofdmDecoder::decodeMscblock (std::vector <std::complex<float>>buffer,
+void	ofdmDecoder::decodeMscblock (std::complex<float> *buffer,
 	                                                  int32_t blkno) {
-int16_t	i;
-	memcpy (fft_buffer, &((buffer. data ())[T_g]), T_u * sizeof (std::complex<float>));
-#endif
-
-fftLabel:
-	my_fftHandler. do_FFT ();
+int32_t	i;
+	enterBlock (buffer, blkno);
+	if (blkno != nrBlocks - 1)
+	   return;
+	transformMsc ();
+	for (i = 4; i < nrBlocks; i ++) {
+	   if ((frameUse [i] == BLOCK_DATA) &&
+	                  (frameUse [i - 1] != BLOCK_SKIPPED)) {
+	      toBits (&carrierBuffer [i * T_u],
+	                             &carrierBuffer [(i - 1) * T_u]);
+	      my_mscHandler -> process_mscBlock (ibits. data (), i);
+	   }
+	   else
+	      my_mscHandler -> process_mscBlock (NULL, i);
+	}
+}
 //
-//	Note that "mapIn" maps to -carriers / 2 .. carriers / 2
-//	we did not set the fft output to low .. high
-toBitsLabel:
-	for (i = 0; i < carriers; i ++) {
-	   int16_t	index	= myMapper. mapIn (i);
-	   if (index < 0) 
-	      index += T_u;
-	      
-	   std::complex<float>	r1 = fft_buffer [index] *
-	                               conj (phaseReference [index]);
-	   float ab1	= jan_abs (r1);
-//	Recall:  the viterbi decoder wants 127 max pos, - 127 max neg
-//	we make the bits into softbits in the range -127 .. 127
-	   ibits [i]		=  - real (r1) / ab1 * 127.0;
-	   ibits [carriers + i] =  - imag (r1) / ab1 * 127.0;
+//	With most of the MSC blocks needed, the batch is fastest.
+//	Otherwise the blocks needed are transformed one by one,
+//	in place in carrierBuffer (which has the alignment the
+//	plan of the fftHandler expects)
+void	ofdmDecoder::transformMsc	(void) {
+int32_t	i;
+int32_t	count	= 0;
+	for (i = 4; i < nrBlocks; i ++) {
+	   frameUse [i]	= blockUse (i);
+	   if (frameUse [i] != BLOCK_SKIPPED)
+	      count ++;
+	}
+	if (count == 0)
+	   return;
+	if (2 * count > nrBlocks - 4) {
+	   mscBatch	-> do_FFT ();
+	   return;
+	}
+	for (i = 4; i < nrBlocks; i ++) {
+	   if (frameUse [i] == BLOCK_SKIPPED)
+	      continue;
+	   memcpy (&carrierBuffer [i * T_u], &frameBuffer [i * T_s + T_g],
+	                               T_u * sizeof (std::complex<float>));
+	   my_fftHandler. do_FFT (&carrierBuffer [i * T_u]);
 	}
-
-	memcpy (phaseReference. data (), fft_buffer,
-	                           T_u * sizeof (std::complex<float>));
-
-handlerLabel:;
-	my_mscHandler -> process_mscBlock (ibits, blkno);
 }
-
+#endif
+/**
+  *	decoding is computing the phase difference between
+  *	carriers with the same index in subsequent blocks.
+  *	The carrier of a block is the reference for the carrier
+  *	on the same position in the next block.
+  *	The softbits are in the range -127 .. 127, as the
+  *	viterbi decoder wants them
+  */
+void	ofdmDecoder::toBits	(std::complex<float> *v,
+	                         std::complex<float> *reference) {
+	demodulateBlock (v, reference, binTable. data (),
+	                               ibits. data (), carriers);
+}
 //
 //
 /**
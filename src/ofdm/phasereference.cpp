@@ -22,6 +22,11 @@
 #include	"phasereference.h" 
 #include	"string.h"
 #include	"radio.h"
+#include	"sample-kernels.h"
+#include	"demod-kernels.h"
+
+#define	TRACK_LENGTH	(T_u / 2)
+#define	SEARCH_RANGE	(2 * 35)
 /**
   *	\class phaseReference
   *	Implements the correlation that is used to identify
@@ -73,6 +78,40 @@ float	Phi_k;
 	for (i = 1; i <= diff_length; i ++) 
 	   phaseDifferences [i - 1] = abs (arg (refTable [(T_u + i) % T_u] *
                                  conj (refTable [(T_u + i + 1) % T_u])));
+	for (i = 1; i < diff_length; i ++)
+	   if (phaseDifferences [i - 1] < 0.1)
+	      nullDiffs. push_back (i);
+	carrierWindow.	resize (SEARCH_RANGE + diff_length + 1);
+	computedDiffs.	resize (SEARCH_RANGE + diff_length);
+//
+//	refDiffs [k] is for carriers -carriers / 2 + k and its successor,
+//	the ones next to carrier 0 are 0
+	peakBuffer.	resize (T_u);
+	spectrum.	resize (T_u);
+	carrierDiffs.	resize (carriers + SEARCH_RANGE);
+	refDiffs.	resize (carriers);
+	for (i = 0; i < carriers; i ++)
+	   refDiffs [i] = refTable [(T_u - carriers / 2 + i) % T_u] *
+	                  conj (refTable [(T_u - carriers / 2 + i + 1) % T_u]);
+//
+//	and the time domain version of block 0, conjugated, for
+//	tracking. Kept as separate real and imaginary parts,
+//	which is easier for the correlation loop
+	refTimeRe.	resize (T_u);
+	refTimeIm.	resize (T_u);
+	trackRe.	resize (T_u);
+	trackIm.	resize (T_u);
+	memcpy (fft_buffer, refTable. data (),
+	                         T_u * sizeof (std::complex<float>));
+	my_fftHandler. do_IFFT ();
+	refEnergy	= 0;
+	for (i = 0; i < T_u; i ++) {
+	   refTimeRe [i]	=   real (fft_buffer [i]) / T_u;
+	   refTimeIm [i]	= - imag (fft_buffer [i]) / T_u;
+	   if (i < TRACK_LENGTH)
+	      refEnergy	+= refTimeRe [i] * refTimeRe [i] +
+	                   refTimeIm [i] * refTimeIm [i];
+	}
 #ifdef	IMPULSE_RESPONSE
 	connect (this, SIGNAL (showImpulse (int)),
 	         mr,   SLOT   (showImpulse (int)));
@@ -92,15 +131,10 @@ float	Phi_k;
   *	looking for.
   */
 
-int32_t	phaseReference::findIndex (std::vector <std::complex<float>> v) {
+int32_t	phaseReference::findIndex (std::complex<float> *v) {
 int32_t	i;
-int32_t	maxIndex	= -1;
-int32_t	oldIndex	= -1;
-float	sum		= 0;
-float	Max		= -1000;
-float	lbuf [T_u];
 
-	memcpy (fft_buffer, v. data (), T_u * sizeof (std::complex<float>));
+	memcpy (fft_buffer, v, T_u * sizeof (std::complex<float>));
 	my_fftHandler. do_FFT ();
 //
 //	into the frequency domain, now correlate
@@ -108,6 +142,19 @@ float	lbuf [T_u];
 	   fft_buffer [i] *= conj (refTable [i]);
 //	and, again, back into the time domain
 	my_fftHandler. do_IFFT ();
+	return peakIndex ();
+}
+
+//
+//	the correlation is in fft_buffer, its maximum is the index
+//	looked for, provided it is clear enough
+int32_t	phaseReference::peakIndex (void) {
+int32_t	i;
+int32_t	maxIndex	= -1;
+float	sum		= 0;
+float	Max		= -1000;
+float	*lbuf		= peakBuffer. data ();
+
 /**
   *	We compute the average and the max signal values
   */
@@ -137,6 +184,120 @@ float	lbuf [T_u];
 	}
 }
 
+/**
+  *	\brief trackIndex
+  *	Once in sync, the start of block 0 hardly moves from frame
+  *	to frame. trackIndex computes the correlation - in the
+  *	time domain - only for the indices expected - window ..
+  *	expected + window, and only over the first TRACK_LENGTH
+  *	samples of block 0, which still gives a clear peak.
+  *	Since the T_u samples in v start in the cyclic prefix,
+  *	the circular correlation is the one findIndex computes.
+  *	Without the correlation over all indices to compare with,
+  *	the peak is compared to the expected average for
+  *	an uncorrelated index, based on the energy in v.
+  *	The result is -1 if that test fails.
+  */
+int32_t	phaseReference::trackIndex (std::complex<float> *v,
+	                            int32_t expected, int32_t window) {
+int32_t	i, d;
+int32_t	maxIndex	= -1;
+float	Max		= -1;
+float	energy		= 0;
+float	*vRe		= trackRe. data ();
+float	*vIm		= trackIm. data ();
+
+	for (i = 0; i < T_u; i ++) {
+	   vRe [i]	= real (v [i]);
+	   vIm [i]	= imag (v [i]);
+	   energy	+= vRe [i] * vRe [i] + vIm [i] * vIm [i];
+	}
+
+	for (d = expected - window; d <= expected + window; d ++) {
+	   if ((d < 0) || (d >= T_u))
+	      continue;
+//	v [d ...] and - circular - v [0 ...]
+	   int32_t first	= T_u - d < TRACK_LENGTH ? T_u - d : TRACK_LENGTH;
+	   std::complex<float> c =
+	          correlate (&vRe [d], &vIm [d],
+	                     refTimeRe. data (), refTimeIm. data (), first);
+	   if (first < TRACK_LENGTH)
+	      c += correlate (vRe, vIm,
+	                      &refTimeRe [first], &refTimeIm [first],
+	                      TRACK_LENGTH - first);
+	   float a	= jan_abs (c);
+	   if (a > Max) {
+	      Max	= a;
+	      maxIndex	= d;
+	   }
+	}
+//
+//	for an uncorrelated index, the correlation is (about) gaussian,
+//	with variance energy / T_u * refEnergy, the average of
+//	jan_abs is then 2 / sqrt (M_PI) times the standard deviation
+	float average	= 2 / sqrt (M_PI) * sqrt (energy / T_u * refEnergy);
+	if (Max < threshold * average)
+	   return -1;
+	return maxIndex;
+}
+
+/**
+  *	\brief acquire
+  *	Time and frequency synchronization in one pass, for when
+  *	the frequency offset is not known yet.
+  *	The integer carrier offset comes first: the product of
+  *	successive carriers does not depend on where in v block 0
+  *	starts, a delay only rotates all products by the same angle.
+  *	So the products are correlated with the ones of the reference
+  *	for all offsets - SEARCH_RANGE / 2 .. SEARCH_RANGE / 2.
+  *	With the spectrum shifted back over the offset found,
+  *	the correlation is the one of findIndex.
+  *	The result is as with findIndex, offset is in carriers, with
+  *	a rough fractional part interpolated from the neighbouring
+  *	correlations. Near a fraction of 0.5 the integer part may be
+  *	either one, the caller will have to decide.
+  */
+int32_t	phaseReference::acquire (std::complex<float> *v, float *offset) {
+int32_t	i;
+int16_t	s;
+int16_t	best	= 0;
+float	Max	= -1;
+float	corr [SEARCH_RANGE + 1];
+int32_t	first	= T_u - carriers / 2 - SEARCH_RANGE / 2;
+
+	memcpy (fft_buffer, v, T_u * sizeof (std::complex<float>));
+	my_fftHandler. do_FFT ();
+	memcpy (spectrum. data (), fft_buffer,
+	                        T_u * sizeof (std::complex<float>));
+	for (i = 0; i < carriers + SEARCH_RANGE; i ++)
+	   carrierDiffs [i] = spectrum [(first + i) % T_u] *
+	                      conj (spectrum [(first + i + 1) % T_u]);
+
+	for (s = - SEARCH_RANGE / 2; s <= SEARCH_RANGE / 2; s ++) {
+	   float a = jan_abs (lagProduct (&carrierDiffs [s + SEARCH_RANGE / 2],
+	                                  refDiffs. data (), carriers));
+	   corr [s + SEARCH_RANGE / 2]	= a;
+	   if (a > Max) {
+	      Max	= a;
+	      best	= s;
+	   }
+	}
+	*offset	= best;
+	if ((best > - SEARCH_RANGE / 2) && (best < SEARCH_RANGE / 2)) {
+	   float l	= corr [best + SEARCH_RANGE / 2 - 1];
+	   float r	= corr [best + SEARCH_RANGE / 2 + 1];
+	   float d	= l - 2 * Max + r;
+	   if (d < 0)
+	      *offset	+= 0.5 * (l - r) / d;
+	}
+
+	for (i = 0; i < T_u; i ++)
+	   fft_buffer [i] = spectrum [(i + best + T_u) % T_u] *
+	                                     conj (refTable [i]);
+	my_fftHandler. do_IFFT ();
+	return peakIndex ();
+}
+
 //	We investigate a sequence of phasedifferences that
 //	are known starting at real carrier 0.
 //	Phase of the carriers of the "real" block 0 may be
@@ -152,36 +313,35 @@ float	lbuf [T_u];
 //	In previous versions we looked
 //	at the "weight" of the positive and negative carriers in the
 //	fft, but that did not work too well.
-#define	SEARCH_RANGE	(2 * 35)
-int16_t	phaseReference::estimate_CarrierOffset (std::vector<std::complex<float>> v) {
+//	The carriers around carrier 0 are first copied - unwrapped -
+//	into a window, such that the phase differences can be computed
+//	in one sweep. computedDiffs [k] then belongs to carrier
+//	k - SEARCH_RANGE / 2.
+int16_t	phaseReference::estimate_CarrierOffset (std::complex<float> *v) {
 int16_t	i, j, index = 100;
-float	diff;
-float	computedDiffs [SEARCH_RANGE + diff_length + 1];
-int	index_1	= 0;
+int16_t	windowSize	= SEARCH_RANGE + diff_length + 1;
 
-	memcpy (fft_buffer, v. data (), T_u * sizeof (std::complex<float>));
+	memcpy (fft_buffer, v, T_u * sizeof (std::complex<float>));
 	my_fftHandler. do_FFT ();
 
-	for (i = T_u - SEARCH_RANGE / 2;
-	     i < T_u + SEARCH_RANGE / 2 + diff_length; i ++) 
-	   computedDiffs [i - (T_u - SEARCH_RANGE / 2)] =
-	      abs (arg (fft_buffer [i % T_u] * conj (fft_buffer [(i + 1) % T_u])));
+	for (i = 0; i < windowSize; i ++)
+	   carrierWindow [i] = fft_buffer [(T_u - SEARCH_RANGE / 2 + i) % T_u];
+	absPhaseDiffs (carrierWindow. data (),
+	               computedDiffs. data (), windowSize - 1);
 
 	float	Mmin = 1000;
-	for (i = T_u - SEARCH_RANGE /2;
-	     i < T_u + SEARCH_RANGE / 2; i ++) {
+	for (i = 0; i < SEARCH_RANGE; i ++) {
 	   float sum = 0;
 
-	   for (j = 1; j < diff_length; j ++)
-	      if (phaseDifferences [j - 1] < 0.1)
-	         sum += computedDiffs [i - (T_u - SEARCH_RANGE / 2) + j];
+	   for (j = 0; j < (int16_t)nullDiffs. size (); j ++)
+	      sum += computedDiffs [i + nullDiffs [j]];
 	   if (sum < Mmin) {
 	      Mmin = sum;
 	      index = i;
 	   }
 	}
 	
-	return index - T_u; 
+	return index - SEARCH_RANGE / 2; 
 }
 //
 //	NOT USED, just for some tests
@@ -192,7 +352,7 @@ int	index_1	= 0;
 //	The values are reasonably close to the values computed
 //	on the fly
 #define	LLENGTH	100
-float	phaseReference::estimate_FrequencyOffset (std::vector <std::complex<float>> v) {
+float	phaseReference::estimate_FrequencyOffset (std::complex<float> *v) {
 int16_t	i, j;
 float pd	= 0;
 
@@ -0,0 +1,416 @@
+#
+/*
+ *    Copyright (C) 2013 .. 2017
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#
+#include	"sample-kernels.h"
+#include	<math.h>
+#if defined (__AVX__)
+#include	<immintrin.h>
+#define	LANES	8
+#elif defined (__SSE2__)
+#include	<emmintrin.h>
+#define	LANES	4
+#else
+#define	LANES	1
+#endif
+
+//
+//	The level tracker is a first order recursion, which does not
+//	vectorize as is. Unrolled over a block of n samples it reads
+//	level_n = b^n * level_0 + a * sum (b^(n - 1 - i) * |v_i|)
+//	with a = LEVEL_ALPHA and b = 1 - a.
+//	The sum is kept in LANES partial sums, each lane being
+//	scaled by b^LANES per step, and weighted by its position
+//	within the group of LANES samples.
+static inline
+float	scalarLevel (std::complex<float> *v,
+	             const std::complex<float> *osc,
+	             int32_t n, float level) {
+int32_t	i;
+	for (i = 0; i < n; i ++) {
+	   v [i]	*= osc [i];
+	   float re	= real (v [i]);
+	   float im	= imag (v [i]);
+	   level	= nextLevel (level, (re < 0 ? -re : re) +
+	                                    (im < 0 ? -im : im));
+	}
+	return level;
+}
+
+static inline
+std::complex<float>	scalarCorrelate (const float *xRe, const float *xIm,
+	                                 const float *rRe, const float *rIm,
+	                                 int32_t n, float re, float im) {
+int32_t	i;
+	for (i = 0; i < n; i ++) {
+	   re	+= xRe [i] * rRe [i] - xIm [i] * rIm [i];
+	   im	+= xRe [i] * rIm [i] + xIm [i] * rRe [i];
+	}
+	return std::complex<float> (re, im);
+}
+
+static inline
+std::complex<float>	scalarLag	(const std::complex<float> *a,
+	                                 const std::complex<float> *b,
+	                                 int32_t n, float re, float im) {
+int32_t	i;
+	for (i = 0; i < n; i ++) {
+	   re	+= real (a [i]) * real (b [i]) + imag (a [i]) * imag (b [i]);
+	   im	+= imag (a [i]) * real (b [i]) - real (a [i]) * imag (b [i]);
+	}
+	return std::complex<float> (re, im);
+}
+
+static inline
+void	scalarEnvelope (std::complex<float> *v,
+	                const std::complex<float> *osc,
+	                float *env, int32_t n) {
+int32_t	i;
+	for (i = 0; i < n; i ++) {
+	   v [i]	*= osc [i];
+	   float re	= real (v [i]);
+	   float im	= imag (v [i]);
+	   env [i]	= (re < 0 ? -re : re) + (im < 0 ? -im : im);
+	}
+}
+
+#if LANES == 8
+//
+//	two times four complex products, v * o
+static inline
+__m256	cmul	(__m256 x, __m256 o) {
+	return _mm256_addsub_ps (
+	          _mm256_mul_ps (x, _mm256_moveldup_ps (o)),
+	          _mm256_mul_ps (_mm256_permute_ps (x, 0xB1),
+	                         _mm256_movehdup_ps (o)));
+}
+
+float	correctAndLevel (std::complex<float> *v,
+	                 const std::complex<float> *osc,
+	                 int32_t n, float level) {
+int32_t	groups	= n / LANES;
+int32_t	i;
+double	b	= 1 - LEVEL_ALPHA;
+float	*fv	= (float *)v;
+const float *fo	= (const float *)osc;
+__m256	absMask	= _mm256_castsi256_ps (_mm256_set1_epi32 (0x7FFFFFFF));
+__m256	acc	= _mm256_setzero_ps ();
+__m256	decay	= _mm256_set1_ps (pow (b, LANES));
+//
+//	hadd leaves the magnitudes in the order 0 1 4 5 2 3 6 7
+__m256	weights	= _mm256_setr_ps (pow (b, 7), pow (b, 6),
+	                          pow (b, 3), pow (b, 2),
+	                          pow (b, 5), pow (b, 4),
+	                          pow (b, 1), 1.0);
+
+	for (i = 0; i < groups; i ++) {
+	   __m256 x0	= _mm256_loadu_ps (&fv [16 * i]);
+	   __m256 x1	= _mm256_loadu_ps (&fv [16 * i + 8]);
+	   __m256 o0	= _mm256_loadu_ps (&fo [16 * i]);
+	   __m256 o1	= _mm256_loadu_ps (&fo [16 * i + 8]);
+	   __m256 r0	= cmul (x0, o0);
+	   __m256 r1	= cmul (x1, o1);
+	   _mm256_storeu_ps (&fv [16 * i], r0);
+	   _mm256_storeu_ps (&fv [16 * i + 8], r1);
+	   __m256 m	= _mm256_hadd_ps (_mm256_and_ps (r0, absMask),
+	                                  _mm256_and_ps (r1, absMask));
+	   acc		= _mm256_add_ps (_mm256_mul_ps (acc, decay),
+	                                 _mm256_mul_ps (m, weights));
+	}
+
+	if (groups > 0) {
+	   float	sums [LANES];
+	   float	sum	= 0;
+	   _mm256_storeu_ps (sums, acc);
+	   for (i = 0; i < LANES; i ++)
+	      sum += sums [i];
+	   level	= pow (b, groups * LANES) * level + LEVEL_ALPHA * sum;
+	}
+	return scalarLevel (&v [groups * LANES], &osc [groups * LANES],
+	                    n - groups * LANES, level);
+}
+
+void	correctAndEnvelope (std::complex<float> *v,
+	                    const std::complex<float> *osc,
+	                    float *env, int32_t n) {
+int32_t	groups	= n / LANES;
+int32_t	i;
+float	*fv	= (float *)v;
+const float *fo	= (const float *)osc;
+__m256	absMask	= _mm256_castsi256_ps (_mm256_set1_epi32 (0x7FFFFFFF));
+
+	for (i = 0; i < groups; i ++) {
+	   __m256 r0	= cmul (_mm256_loadu_ps (&fv [16 * i]),
+	                        _mm256_loadu_ps (&fo [16 * i]));
+	   __m256 r1	= cmul (_mm256_loadu_ps (&fv [16 * i + 8]),
+	                        _mm256_loadu_ps (&fo [16 * i + 8]));
+	   _mm256_storeu_ps (&fv [16 * i], r0);
+	   _mm256_storeu_ps (&fv [16 * i + 8], r1);
+	   __m256 m	= _mm256_hadd_ps (_mm256_and_ps (r0, absMask),
+	                                  _mm256_and_ps (r1, absMask));
+//	restore the sample order 0 1 2 3 4 5 6 7
+	   __m128d lo	= _mm_castps_pd (_mm256_castps256_ps128 (m));
+	   __m128d hi	= _mm_castps_pd (_mm256_extractf128_ps (m, 1));
+	   _mm_storeu_pd ((double *)&env [LANES * i],
+	                                   _mm_unpacklo_pd (lo, hi));
+	   _mm_storeu_pd ((double *)&env [LANES * i + 4],
+	                                   _mm_unpackhi_pd (lo, hi));
+	}
+	scalarEnvelope (&v [groups * LANES], &osc [groups * LANES],
+	                &env [groups * LANES], n - groups * LANES);
+}
+
+std::complex<float>	correlate	(const float *xRe, const float *xIm,
+	                                 const float *rRe, const float *rIm,
+	                                 int32_t n) {
+int32_t	groups	= n / LANES;
+int32_t	i;
+__m256	re	= _mm256_setzero_ps ();
+__m256	im	= _mm256_setzero_ps ();
+float	sumRe [LANES];
+float	sumIm [LANES];
+
+	for (i = 0; i < groups; i ++) {
+	   __m256 a	= _mm256_loadu_ps (&xRe [LANES * i]);
+	   __m256 b	= _mm256_loadu_ps (&xIm [LANES * i]);
+	   __m256 c	= _mm256_loadu_ps (&rRe [LANES * i]);
+	   __m256 d	= _mm256_loadu_ps (&rIm [LANES * i]);
+	   re	= _mm256_add_ps (re, _mm256_sub_ps (_mm256_mul_ps (a, c),
+	                                            _mm256_mul_ps (b, d)));
+	   im	= _mm256_add_ps (im, _mm256_add_ps (_mm256_mul_ps (a, d),
+	                                            _mm256_mul_ps (b, c)));
+	}
+	_mm256_storeu_ps (sumRe, re);
+	_mm256_storeu_ps (sumIm, im);
+	for (i = 1; i < LANES; i ++) {
+	   sumRe [0] += sumRe [i];
+	   sumIm [0] += sumIm [i];
+	}
+	return scalarCorrelate (&xRe [groups * LANES], &xIm [groups * LANES],
+	                        &rRe [groups * LANES], &rIm [groups * LANES],
+	                        n - groups * LANES, sumRe [0], sumIm [0]);
+}
+
+//
+//	the samples are taken as they are, interleaved:
+//	a * b gives re * re and im * im, a * swapped (b) gives
+//	re * im and im * re, the signs are settled at the end
+std::complex<float>	lagProduct	(const std::complex<float> *a,
+	                                 const std::complex<float> *b,
+	                                 int32_t n) {
+int32_t	groups	= n / (LANES / 2);
+int32_t	i;
+const float *fa	= (const float *)a;
+const float *fb	= (const float *)b;
+__m256	same	= _mm256_setzero_ps ();
+__m256	cross	= _mm256_setzero_ps ();
+float	sumS [LANES];
+float	sumC [LANES];
+
+	for (i = 0; i < groups; i ++) {
+	   __m256 x	= _mm256_loadu_ps (&fa [LANES * i]);
+	   __m256 y	= _mm256_loadu_ps (&fb [LANES * i]);
+	   same		= _mm256_add_ps (same, _mm256_mul_ps (x, y));
+	   cross	= _mm256_add_ps (cross,
+	                         _mm256_mul_ps (x, _mm256_permute_ps (y, 0xB1)));
+	}
+	_mm256_storeu_ps (sumS, same);
+	_mm256_storeu_ps (sumC, cross);
+	for (i = 2; i < LANES; i += 2) {
+	   sumS [0] += sumS [i];
+	   sumS [1] += sumS [i + 1];
+	   sumC [0] += sumC [i];
+	   sumC [1] += sumC [i + 1];
+	}
+	return scalarLag (&a [groups * LANES / 2], &b [groups * LANES / 2],
+	                  n - groups * LANES / 2,
+	                  sumS [0] + sumS [1], sumC [1] - sumC [0]);
+}
+#elif LANES == 4
+//
+//	two complex products, v * o
+static inline
+__m128	cmul	(__m128 x, __m128 o) {
+static const float signs [4] = {-1, 1, -1, 1};
+	return _mm_add_ps (
+	          _mm_mul_ps (x, _mm_shuffle_ps (o, o, _MM_SHUFFLE (2, 2, 0, 0))),
+	          _mm_mul_ps (_mm_loadu_ps (signs),
+	             _mm_mul_ps (_mm_shuffle_ps (x, x, _MM_SHUFFLE (2, 3, 0, 1)),
+	                         _mm_shuffle_ps (o, o, _MM_SHUFFLE (3, 3, 1, 1)))));
+}
+
+float	correctAndLevel (std::complex<float> *v,
+	                 const std::complex<float> *osc,
+	                 int32_t n, float level) {
+int32_t	groups	= n / LANES;
+int32_t	i;
+double	b	= 1 - LEVEL_ALPHA;
+float	*fv	= (float *)v;
+const float *fo	= (const float *)osc;
+__m128	absMask	= _mm_castsi128_ps (_mm_set1_epi32 (0x7FFFFFFF));
+__m128	acc	= _mm_setzero_ps ();
+__m128	decay	= _mm_set1_ps (pow (b, LANES));
+__m128	weights	= _mm_setr_ps (pow (b, 3), pow (b, 2), pow (b, 1), 1.0);
+
+	for (i = 0; i < groups; i ++) {
+	   __m128 x0	= _mm_loadu_ps (&fv [8 * i]);
+	   __m128 x1	= _mm_loadu_ps (&fv [8 * i + 4]);
+	   __m128 o0	= _mm_loadu_ps (&fo [8 * i]);
+	   __m128 o1	= _mm_loadu_ps (&fo [8 * i + 4]);
+	   __m128 r0	= cmul (x0, o0);
+	   __m128 r1	= cmul (x1, o1);
+	   _mm_storeu_ps (&fv [8 * i], r0);
+	   _mm_storeu_ps (&fv [8 * i + 4], r1);
+	   __m128 a0	= _mm_and_ps (r0, absMask);
+	   __m128 a1	= _mm_and_ps (r1, absMask);
+	   __m128 m	= _mm_add_ps (
+	                     _mm_shuffle_ps (a0, a1, _MM_SHUFFLE (2, 0, 2, 0)),
+	                     _mm_shuffle_ps (a0, a1, _MM_SHUFFLE (3, 1, 3, 1)));
+	   acc		= _mm_add_ps (_mm_mul_ps (acc, decay),
+	                              _mm_mul_ps (m, weights));
+	}
+
+	if (groups > 0) {
+	   float	sums [LANES];
+	   _mm_storeu_ps (sums, acc);
+	   level	= pow (b, groups * LANES) * level +
+	                  LEVEL_ALPHA * (sums [0] + sums [1] + sums [2] + sums [3]);
+	}
+	return scalarLevel (&v [groups * LANES], &osc [groups * LANES],
+	                    n - groups * LANES, level);
+}
+
+void	correctAndEnvelope (std::complex<float> *v,
+	                    const std::complex<float> *osc,
+	                    float *env, int32_t n) {
+int32_t	groups	= n / LANES;
+int32_t	i;
+float	*fv	= (float *)v;
+const float *fo	= (const float *)osc;
+__m128	absMask	= _mm_castsi128_ps (_mm_set1_epi32 (0x7FFFFFFF));
+
+	for (i = 0; i < groups; i ++) {
+	   __m128 r0	= cmul (_mm_loadu_ps (&fv [8 * i]),
+	                        _mm_loadu_ps (&fo [8 * i]));
+	   __m128 r1	= cmul (_mm_loadu_ps (&fv [8 * i + 4]),
+	                        _mm_loadu_ps (&fo [8 * i + 4]));
+	   _mm_storeu_ps (&fv [8 * i], r0);
+	   _mm_storeu_ps (&fv [8 * i + 4], r1);
+	   __m128 a0	= _mm_and_ps (r0, absMask);
+	   __m128 a1	= _mm_and_ps (r1, absMask);
+	   _mm_storeu_ps (&env [LANES * i],
+	                  _mm_add_ps (
+	                     _mm_shuffle_ps (a0, a1, _MM_SHUFFLE (2, 0, 2, 0)),
+	                     _mm_shuffle_ps (a0, a1, _MM_SHUFFLE (3, 1, 3, 1))));
+	}
+	scalarEnvelope (&v [groups * LANES], &osc [groups * LANES],
+	                &env [groups * LANES], n - groups * LANES);
+}
+//
+//	two times four lanes, to hide the latency of the additions
+std::complex<float>	correlate	(const float *xRe, const float *xIm,
+	                                 const float *rRe, const float *rIm,
+	                                 int32_t n) {
+int32_t	groups	= n / (2 * LANES);
+int32_t	i, j;
+__m128	re [2]	= {_mm_setzero_ps (), _mm_setzero_ps ()};
+__m128	im [2]	= {_mm_setzero_ps (), _mm_setzero_ps ()};
+float	sumRe [LANES];
+float	sumIm [LANES];
+
+	for (i = 0; i < groups; i ++) {
+	   for (j = 0; j < 2; j ++) {
+	      int32_t k	= 2 * LANES * i + LANES * j;
+	      __m128 a	= _mm_loadu_ps (&xRe [k]);
+	      __m128 b	= _mm_loadu_ps (&xIm [k]);
+	      __m128 c	= _mm_loadu_ps (&rRe [k]);
+	      __m128 d	= _mm_loadu_ps (&rIm [k]);
+	      re [j]	= _mm_add_ps (re [j], _mm_sub_ps (_mm_mul_ps (a, c),
+	                                                  _mm_mul_ps (b, d)));
+	      im [j]	= _mm_add_ps (im [j], _mm_add_ps (_mm_mul_ps (a, d),
+	                                                  _mm_mul_ps (b, c)));
+	   }
+	}
+	_mm_storeu_ps (sumRe, _mm_add_ps (re [0], re [1]));
+	_mm_storeu_ps (sumIm, _mm_add_ps (im [0], im [1]));
+	return scalarCorrelate (&xRe [groups * 2 * LANES],
+	                        &xIm [groups * 2 * LANES],
+	                        &rRe [groups * 2 * LANES],
+	                        &rIm [groups * 2 * LANES],
+	                        n - groups * 2 * LANES,
+	                        sumRe [0] + sumRe [1] + sumRe [2] + sumRe [3],
+	                        sumIm [0] + sumIm [1] + sumIm [2] + sumIm [3]);
+}
+
+//
+//	see the AVX version
+std::complex<float>	lagProduct	(const std::complex<float> *a,
+	                                 const std::complex<float> *b,
+	                                 int32_t n) {
+int32_t	groups	= n / (LANES / 2);
+int32_t	i;
+const float *fa	= (const float *)a;
+const float *fb	= (const float *)b;
+__m128	same	= _mm_setzero_ps ();
+__m128	cross	= _mm_setzero_ps ();
+float	sumS [LANES];
+float	sumC [LANES];
+
+	for (i = 0; i < groups; i ++) {
+	   __m128 x	= _mm_loadu_ps (&fa [LANES * i]);
+	   __m128 y	= _mm_loadu_ps (&fb [LANES * i]);
+	   same		= _mm_add_ps (same, _mm_mul_ps (x, y));
+	   cross	= _mm_add_ps (cross,
+	                     _mm_mul_ps (x, _mm_shuffle_ps (y, y, 0xB1)));
+	}
+	_mm_storeu_ps (sumS, same);
+	_mm_storeu_ps (sumC, cross);
+	return scalarLag (&a [groups * LANES / 2], &b [groups * LANES / 2],
+	                  n - groups * LANES / 2,
+	                  sumS [0] + sumS [1] + sumS [2] + sumS [3],
+	                  sumC [1] + sumC [3] - sumC [0] - sumC [2]);
+}
+#else
+float	correctAndLevel (std::complex<float> *v,
+	                 const std::complex<float> *osc,
+	                 int32_t n, float level) {
+	return scalarLevel (v, osc, n, level);
+}
+
+void	correctAndEnvelope (std::complex<float> *v,
+	                    const std::complex<float> *osc,
+	                    float *env, int32_t n) {
+	scalarEnvelope (v, osc, env, n);
+}
+
+std::complex<float>	correlate	(const float *xRe, const float *xIm,
+	                                 const float *rRe, const float *rIm,
+	                                 int32_t n) {
+	return scalarCorrelate (xRe, xIm, rRe, rIm, n, 0, 0);
+}
+
+std::complex<float>	lagProduct	(const std::complex<float> *a,
+	                                 const std::complex<float> *b,
+	                                 int32_t n) {
+	return scalarLag (a, b, n, 0, 0);
+}
+#endif
+
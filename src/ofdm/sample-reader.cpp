@@ -33,18 +33,18 @@ int16_t res     = 1;
 
 	sampleReader::sampleReader (RadioInterface *mr,
 	                            virtualInput	*theRig) {
-int	i;
 	this	-> theRig	= theRig;
         bufferSize		= 32768;
         localCounter		= 0;
 	currentPhase	= 0;
 	sLevel		= 0;
 	sampleCount	= 0;
-	oscillatorTable = new std::complex<float> [INPUT_RATE];
-        for (i = 0; i < INPUT_RATE; i ++)
-           oscillatorTable [i] = std::complex<float>
-	                            (cos (2.0 * M_PI * i / INPUT_RATE),
-                                     sin (2.0 * M_PI * i / INPUT_RATE));
+	phasor		= std::complex<double> (1, 0);
+	stepOffset	= 0;
+	stepPhasor	= std::complex<double> (1, 0);
+	anchorCount	= 0;
+	pendingIndex	= 0;
+	pendingCount	= 0;
 
 	bufferContent	= 0;
 	corrector	= 0;
@@ -54,11 +54,13 @@ int	i;
 }
 
 	sampleReader::~sampleReader (void) {
-	delete[] oscillatorTable;
 }
 
 void	sampleReader::setRunning (bool b) {
 	running. store (b);
+//	a reader waiting for samples should see the change now
+	if (!b)
+	   theRig -> signalSamples ();
 }
 
 float	sampleReader::get_sLevel (void) {
@@ -72,11 +74,18 @@ std::complex<float> temp;
 	if (!running. load ())
 	   throw 21;
 
+//	samples already looked at by the null detector go first
+	if (pendingCount > 0) {
+	   temp	= pendingBuffer [pendingIndex];
+	   consume (1);
+	   return temp;
+	}
+
 ///	bufferContent is an indicator for the value of ... -> Samples ()
 	if (bufferContent == 0) {
 	   bufferContent = theRig -> Samples ();
 	   while ((bufferContent <= 2048) && running. load ()) {
-	      usleep (10);
+	      theRig -> waitForSamples (2048 + 1, WAIT_TIMEOUT);
 	      bufferContent = theRig -> Samples (); 
 	   }
 	}
@@ -101,9 +110,14 @@ std::complex<float> temp;
 //	first: adjust frequency. We need Hz accuracy
 	currentPhase	-= phaseOffset;
 	currentPhase	= (currentPhase + INPUT_RATE) % INPUT_RATE;
+	setStep (phaseOffset);
+	if (++anchorCount >= ANCHOR_PERIOD)
+	   setAnchor ();
+	else
+	   phasor	*= stepPhasor;
 
-	temp		*= oscillatorTable [currentPhase];
-	sLevel		= 0.00001 * jan_abs (temp) + (1 - 0.00001) * sLevel;
+	temp		*= std::complex<float> (phasor);
+	sLevel		= nextLevel (sLevel, jan_abs (temp));
 #define	N	5
 	sampleCount	++;
 	if (++ sampleCount > INPUT_RATE / N) {
@@ -115,15 +129,107 @@ std::complex<float> temp;
 
 void	sampleReader::getSamples (std::complex<float>  *v,
 	                          int16_t n, int32_t phaseOffset) {
-int32_t		i;
+	corrector	= phaseOffset;
+	if (!running. load ())
+	   throw 21;
+
+//	samples already looked at by the null detector go first
+	if (pendingCount > 0) {
+	   int16_t amount = pendingCount < n ? pendingCount : n;
+	   memcpy (v, &pendingBuffer [pendingIndex],
+	                   amount * sizeof (std::complex<float>));
+	   consume (amount);
+	   v	+= amount;
+	   n	-= amount;
+	   if (n == 0)
+	      return;
+	}
 
+	n	= fetchSamples (v, n);
+
+//	OK, we have samples!!
+//	first: adjust frequency. We need Hz accuracy
+//	The oscillator values are generated first, the correction and
+//	the level tracking are then done as a single block operation
+	if ((int32_t)(oscillatorBuffer. size ()) < n)
+	   oscillatorBuffer. resize (n);
+	makeOscillator (oscillatorBuffer. data (), n, phaseOffset);
+	sLevel	= correctAndLevel (v, oscillatorBuffer. data (), n, sLevel);
+
+	sampleCount	+= n;
+	if (sampleCount > INPUT_RATE / N) {
+	   show_Corrector	(corrector);
+	   localCounter = 0;
+	   sampleCount = 0;
+	}
+}
+
+//
+//	For the time synchronization, looking for the null period,
+//	only the envelope of the signal is needed. peekEnvelope reads
+//	a block of (frequency corrected) samples and returns their
+//	envelope, without consuming them. The caller tells - through
+//	consume - how many were actually used, the remaining samples
+//	will be returned first by subsequent calls of getSample(s).
+//	The level is only updated for samples being consumed, so
+//	the decisions of the detector are the same as they were
+//	when reading sample by sample.
+int32_t	sampleReader::peekEnvelope (const float **env,
+	                            int32_t n, int32_t phaseOffset) {
 	corrector	= phaseOffset;
 	if (!running. load ())
 	   throw 21;
+
+	if (pendingCount == 0) {
+	   if ((int32_t)(pendingBuffer. size ()) < n) {
+	      pendingBuffer. resize (n);
+	      pendingEnvelope. resize (n);
+	   }
+	   if ((int32_t)(oscillatorBuffer. size ()) < n)
+	      oscillatorBuffer. resize (n);
+	   pendingCount	= fetchSamples (pendingBuffer. data (), n);
+	   pendingIndex	= 0;
+	   makeOscillator (oscillatorBuffer. data (),
+	                   pendingCount, phaseOffset);
+	   correctAndEnvelope (pendingBuffer. data (),
+	                       oscillatorBuffer. data (),
+	                       pendingEnvelope. data (), pendingCount);
+	   sampleCount	+= pendingCount;
+	   if (sampleCount > INPUT_RATE / N) {
+	      show_Corrector	(corrector);
+	      sampleCount = 0;
+	   }
+	}
+
+	*env	= &pendingEnvelope [pendingIndex];
+	return pendingCount < n ? pendingCount : n;
+}
+
+void	sampleReader::consume	(int32_t n) {
+int32_t	i;
+
+	for (i = 0; i < n; i ++)
+	   sLevel	= nextLevel (sLevel, pendingEnvelope [pendingIndex + i]);
+	pendingIndex	+= n;
+	pendingCount	-= n;
+}
+
+void	sampleReader::resetBuffer	(void) {
+	pendingIndex	= 0;
+	pendingCount	= 0;
+	bufferContent	= 0;
+}
+
+//
+//	wait until n samples are available, read them and - if
+//	requested - dump them. Returns the number of samples read
+int32_t	sampleReader::fetchSamples (std::complex<float> *v, int32_t n) {
+int32_t	i;
+
 	if (n > bufferContent) {
 	   bufferContent = theRig -> Samples ();
 	   while ((bufferContent < n) && running. load ()) {
-	      usleep (10);
+	      theRig -> waitForSamples (n, WAIT_TIMEOUT);
 	      bufferContent = theRig -> Samples ();
 	   }
 	}
@@ -145,24 +251,47 @@ int32_t		i;
 	      }
 	   }
 	}
+	return n;
+}
 
-//	OK, we have samples!!
-//	first: adjust frequency. We need Hz accuracy
-	for (i = 0; i < n; i ++) {
-	   currentPhase	-= phaseOffset;
 //
-//	Note that "phase" itself might be negative
-	   currentPhase	= (currentPhase + INPUT_RATE) % INPUT_RATE;
-	   v [i]	*= oscillatorTable [currentPhase];
-	   sLevel	= 0.00001 * jan_abs (v [i]) + (1 - 0.00001) * sLevel;
-	}
+//	The oscillator is a rotator, a phasor that is multiplied by
+//	exp (-j * 2 * pi * phaseOffset / INPUT_RATE) for each sample.
+//	The phase itself is still maintained as an integer (in Hz
+//	units), and the phasor is reset to the value for that phase
+//	at the end of each block and every ANCHOR_PERIOD single samples,
+//	so rounding errors cannot accumulate.
+//	This replaces a table with INPUT_RATE entries (16 Mbyte)
+void	sampleReader::setStep (int32_t phaseOffset) {
+	if (phaseOffset == stepOffset)
+	   return;
+	stepOffset	= phaseOffset;
+	stepPhasor	= std::polar (1.0, - 2 * M_PI * phaseOffset / INPUT_RATE);
+}
 
-	sampleCount	+= n;
-	if (sampleCount > INPUT_RATE / N) {
-	   show_Corrector	(corrector);
-	   localCounter = 0;
-	   sampleCount = 0;
+void	sampleReader::setAnchor	(void) {
+	phasor		= std::polar (1.0, 2 * M_PI * currentPhase / INPUT_RATE);
+	anchorCount	= 0;
+}
+
+void	sampleReader::makeOscillator (std::complex<float> *osc,
+	                              int32_t n, int32_t phaseOffset) {
+std::complex<double> w	= phasor;
+int32_t	i;
+
+	setStep (phaseOffset);
+	for (i = 0; i < n; i ++) {
+	   w		*= stepPhasor;
+	   osc [i]	= std::complex<float> (w);
+//	keep |w| at 1, one Newton step is sufficient
+	   if ((i & 01777) == 01777)
+	      w		*= 1.5 - 0.5 * norm (w);
 	}
+	currentPhase	= (int32_t)((currentPhase - (int64_t)n * phaseOffset)
+	                                                 % INPUT_RATE);
+	if (currentPhase < 0)
+	   currentPhase += INPUT_RATE;
+	setAnchor ();
 }
 
 void	sampleReader::startDumping (SNDFILE *f) {
@@ -0,0 +1,48 @@
+#
+/*
+ *    Copyright (C) 2013 .. 2017
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#
+#include	"cpu-features.h"
+
+#if defined (__x86_64__) || defined (__i386__)
+//
+//	the answers are computed once, the first time they are asked for
+bool	cpu_hasSSSE3	(void) {
+static const bool ssse3	=
+	        (__builtin_cpu_init (), __builtin_cpu_supports ("ssse3"));
+	return ssse3;
+}
+
+bool	cpu_hasAVX2	(void) {
+static const bool avx2	=
+	        (__builtin_cpu_init (), __builtin_cpu_supports ("avx2"));
+	return avx2;
+}
+#else
+bool	cpu_hasSSSE3	(void) {
+	return false;
+}
+
+bool	cpu_hasAVX2	(void) {
+	return false;
+}
+#endif
+
@@ -22,6 +22,77 @@
  */
 #include	"fft-handler.h"
 #include	<cstring>
+#include	<QMutex>
+#include	<chrono>
+
+//
+//	The fftw planner is not reentrant, and the planning flags
+//	and wisdom are shared by all handlers, so all planning
+//	goes through makePlan
+static	QMutex		plannerLock;
+static	unsigned	planFlags	= FFTW_ESTIMATE;
+static	QString		wisdomName	= "";
+
+static
+unsigned	effortFlags	(const QString &effort) {
+	if (effort == "patient")
+	   return FFTW_PATIENT;
+	if (effort == "measure")
+	   return FFTW_MEASURE;
+	return FFTW_ESTIMATE;
+}
+
+static inline
+double	getMyTime	(void) {
+	return std::chrono::duration <double, std::milli>
+	          (std::chrono::steady_clock::now (). time_since_epoch ()).
+	                                                           count ();
+}
+
+void	setFFTplanning	(const QString &effort, const QString &wisdomFile) {
+	plannerLock. lock ();
+	planFlags	= effortFlags (effort);
+	wisdomName	= wisdomFile;
+	if ((planFlags != FFTW_ESTIMATE) && (wisdomName != "")) {
+	   if (FFTW_IMPORT_WISDOM (wisdomName. toLatin1 (). data ()))
+	      fprintf (stderr, "fft: wisdom loaded from %s\n",
+	                                 wisdomName. toLatin1 (). data ());
+	   else
+	      fprintf (stderr, "fft: no wisdom yet in %s\n",
+	                                 wisdomName. toLatin1 (). data ());
+	}
+	plannerLock. unlock ();
+}
+//
+//	n FFTs of size fftSize, as in fftwf_plan_many_dft.
+//	With measured plans, the wisdom - possibly extended - is
+//	saved right away, planning is only done at startup anyway
+static
+FFTW_PLAN	makePlan	(int fftSize, int n,
+	                         std::complex<float> *in, int inDistance,
+	                         std::complex<float> *out, int outDistance,
+	                         int direction) {
+FFTW_PLAN	plan;
+double	t0;
+	plannerLock. lock ();
+	t0	= getMyTime ();
+	plan	= FFTW_PLAN_MANY_DFT (1, &fftSize, n,
+	                              reinterpret_cast <fftwf_complex *>(in),
+	                              NULL, 1, inDistance,
+	                              reinterpret_cast <fftwf_complex *>(out),
+	                              NULL, 1, outDistance,
+	                              direction, planFlags);
+	t0	= getMyTime () - t0;
+	if (planFlags != FFTW_ESTIMATE) {
+	   fprintf (stderr, "fft: plan for %d x %d made in %.1f msec\n",
+	                                            n, fftSize, t0);
+	   if (wisdomName != "")
+	      FFTW_EXPORT_WISDOM (wisdomName. toLatin1 (). data ());
+	}
+	plannerLock. unlock ();
+	return plan;
+}
+
 //
 //	The basic idea was to have a single instance of the
 //	fftHandler, for all DFT's. Makes sense, since they are all
@@ -33,10 +104,8 @@
 	this	-> fftSize = p. get_T_u ();
 	vector	= (std::complex<float> *)
 	          FFTW_MALLOC (sizeof (std::complex<float>) * fftSize);
-	plan	= FFTW_PLAN_DFT_1D (fftSize,
-	                            reinterpret_cast <fftwf_complex *>(vector),
-	                            reinterpret_cast <fftwf_complex *>(vector),
-	                            FFTW_FORWARD, FFTW_ESTIMATE);
+	plan	= makePlan (fftSize, 1, vector, fftSize,
+	                            vector, fftSize, FFTW_FORWARD);
 }
 
 	fftHandler::~fftHandler (void) {
@@ -51,6 +120,11 @@ std::complex<float>	*fftHandler::getVector (void) {
 void	fftHandler::do_FFT (void) {
 	FFTW_EXECUTE (plan);
 }
+
+void	fftHandler::do_FFT (std::complex<float> *v) {
+	FFTW_EXECUTE_DFT (plan, reinterpret_cast <fftwf_complex *>(v),
+	                        reinterpret_cast <fftwf_complex *>(v));
+}
 //
 //	Note that we do not scale here, not needed
 //	for the purpose we are using it for
@@ -64,6 +138,85 @@ int16_t i;
 	   vector [i] = conj (vector [i]);
 }
 
+//
+//	The plan is made for the buffers passed, so executing it
+//	needs no copying in or out
+	fftBatch::fftBatch (uint8_t mode, int32_t howMany,
+	                    std::complex<float> *in, int32_t inDistance,
+	                    std::complex<float> *out) {
+dabParams p (mode);
+int	fftSize	= p. get_T_u ();
+
+	plan	= makePlan (fftSize, howMany, in, inDistance,
+	                            out, fftSize, FFTW_FORWARD);
+}
+
+	fftBatch::~fftBatch	(void) {
+	FFTW_DESTROY_PLAN (plan);
+}
+
+void	fftBatch::do_FFT	(void) {
+	FFTW_EXECUTE (plan);
+}
+
+//
+//	execution time of an FFT (batch), in usec
+static
+double	timeFFT	(fftHandler *h) {
+int	i;
+double	t0	= getMyTime ();
+	for (i = 0; i < 200; i ++)
+	   h -> do_FFT ();
+	return (getMyTime () - t0) * 1000 / 200;
+}
+
+static
+double	timeFFT	(fftBatch *b) {
+int	i;
+double	t0	= getMyTime ();
+	for (i = 0; i < 200; i ++)
+	   b -> do_FFT ();
+	return (getMyTime () - t0) * 1000 / 200;
+}
+//
+//	The plans made here should be the ones the ofdm part uses,
+//	i.e. the plain T_u plan of the fftHandler and the two
+//	batches (FIC and MSC blocks) of the ofdmDecoder
+void	generateFFTwisdom (const QString &effort, const QString &wisdomFile) {
+uint8_t	mode;
+	setFFTplanning (effort, wisdomFile);
+	for (mode = 1; mode <= 4; mode ++) {
+	   dabParams p (mode);
+	   int32_t	T_u	= p. get_T_u ();
+	   int32_t	T_s	= p. get_T_s ();
+	   int32_t	L	= p. get_L ();
+	   double	t0	= getMyTime ();
+	   std::complex<float> *frame	= (std::complex<float> *)
+	          FFTW_MALLOC (sizeof (std::complex<float>) * L * T_s);
+	   std::complex<float> *carriers	= (std::complex<float> *)
+	          FFTW_MALLOC (sizeof (std::complex<float>) * L * T_u);
+	   fftHandler	*single	= new fftHandler (mode);
+	   fftBatch	*fic	= new fftBatch (mode, 4,
+	                                        &frame [T_s - T_u], T_s,
+	                                        carriers);
+	   fftBatch	*msc	= new fftBatch (mode, L - 4,
+	                                        &frame [4 * T_s + T_s - T_u], T_s,
+	                                        &carriers [4 * T_u]);
+	   fprintf (stderr, "mode %d: planning %.1f msec\n",
+	                                    mode, getMyTime () - t0);
+	   memset ((void *)frame, 0, sizeof (std::complex<float>) * L * T_s);
+	   fprintf (stderr,
+	       "mode %d: fft %.2f usec, fic batch %.2f, msc batch %.2f usec per symbol\n",
+	                    mode, timeFFT (single),
+	                    timeFFT (fic) / 4, timeFFT (msc) / (L - 4));
+	   delete single;
+	   delete fic;
+	   delete msc;
+	   FFTW_FREE (frame);
+	   FFTW_FREE (carriers);
+	}
+}
+
 //	Obsolete
 	common_ifft::common_ifft (int32_t fft_size) {
 int32_t	i;